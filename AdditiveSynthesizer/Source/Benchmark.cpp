@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    Benchmark.cpp
+
+    Standalone console benchmark for the synthesis hot path. Not compiled
+    into the plugin (compile="0" in AdditiveSynthesizer.jucer) — it has its
+    own console-app project, Benchmark.jucer, built against the same modules;
+    open that in the Projucer and export, or make the generated
+    Builds/BenchmarkLinuxMakefile. It instantiates AdditiveSynthAudioProcessor
+    headlessly, feeds it scripted MIDI, and reports ns-per-sample and
+    blocks-over-deadline per engine mode. For cache-miss counters run it
+    under `perf stat -e cache-misses,cache-references`.
+
+    Usage: AdditiveSynthBenchmark [polyphony] [bufferSize] [sampleRate] [seconds]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <cstdio>
+#include <cstdlib>
+#include "additive_synth.h"
+
+namespace
+{
+    struct BenchmarkResult
+    {
+        double nsPerSample = 0.0;
+        double worstBlockMs = 0.0;
+        int blocksOverDeadline = 0;
+        int totalBlocks = 0;
+    };
+
+    BenchmarkResult runBenchmark(HarmonicOscillator::Engine engine, int polyphony,
+                                 int bufferSize, double sampleRate, int seconds)
+    {
+        AdditiveSynthAudioProcessor processor;
+        processor.setSynthesisEngine(engine);
+        processor.prepareToPlay(sampleRate, bufferSize);
+
+        juce::AudioBuffer<float> buffer(2, bufferSize);
+        juce::MidiBuffer midi;
+
+        // Scripted MIDI: fill the requested polyphony in the first block,
+        // spread across the keyboard so band-limiting behaves realistically.
+        for (int v = 0; v < polyphony; ++v)
+            midi.addEvent(juce::MidiMessage::noteOn(1, 36 + (v * 7) % 49, 0.8f), 0);
+
+        BenchmarkResult result;
+        result.totalBlocks = static_cast<int>(seconds * sampleRate / bufferSize);
+
+        const double deadlineMs = 1000.0 * bufferSize / sampleRate;
+        const double ticksPerSecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+        int64_t totalTicks = 0;
+
+        for (int block = 0; block < result.totalBlocks; ++block)
+        {
+            auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+            totalTicks += elapsed;
+            double blockMs = 1000.0 * elapsed / ticksPerSecond;
+            result.worstBlockMs = juce::jmax(result.worstBlockMs, blockMs);
+            if (blockMs > deadlineMs)
+                ++result.blocksOverDeadline;
+
+            midi.clear();
+        }
+
+        int64_t totalSamples = static_cast<int64_t>(result.totalBlocks) * bufferSize;
+        result.nsPerSample = 1.0e9 * totalTicks / (ticksPerSecond * static_cast<double>(totalSamples));
+        return result;
+    }
+
+    const char* engineName(HarmonicOscillator::Engine engine)
+    {
+        return engine == HarmonicOscillator::Engine::oscillatorBank ? "oscillatorBank" : "inverseFFT";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    int polyphony = argc > 1 ? std::atoi(argv[1]) : Constants::MAX_VOICES;
+    int bufferSize = argc > 2 ? std::atoi(argv[2]) : 64;
+    double sampleRate = argc > 3 ? std::atof(argv[3]) : 48000.0;
+    int seconds = argc > 4 ? std::atoi(argv[4]) : 10;
+
+    std::printf("AdditiveSynthesizer benchmark — %d voices, %d-sample buffers, %.0f Hz, %d s\n\n",
+                polyphony, bufferSize, sampleRate, seconds);
+    std::printf("%-16s %14s %14s %20s\n", "engine", "ns/sample", "worst block", "blocks over deadline");
+
+    for (auto engine : { HarmonicOscillator::Engine::oscillatorBank,
+                         HarmonicOscillator::Engine::inverseFFT })
+    {
+        auto result = runBenchmark(engine, polyphony, bufferSize, sampleRate, seconds);
+        std::printf("%-16s %14.1f %12.3fms %12d / %d\n",
+                    engineName(engine), result.nsPerSample, result.worstBlockMs,
+                    result.blocksOverDeadline, result.totalBlocks);
+    }
+
+    return 0;
+}
@@ -26,7 +26,13 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <thread>
 #include <vector>
 #include <memory>
 
@@ -36,8 +42,9 @@
 namespace Constants
 {
     constexpr int MAX_HARMONICS = 128;
-    constexpr int MAX_VOICES = 16;
+    constexpr int MAX_VOICES = 64;
     constexpr int VISIBLE_HARMONICS = 32;
+    constexpr int SINE_TABLE_SIZE = 1024; // 4 KB — stays L1-resident across all partials
     constexpr float TWO_PI = 6.28318530717958647692f;
     constexpr float PI = 3.14159265358979323846f;
     constexpr float A4_FREQUENCY = 440.0f;
@@ -70,16 +77,18 @@ public:
         {
             harmonics[index].amplitude = juce::jlimit(0.0f, 1.0f, amplitude);
             harmonics[index].phase = phase;
-            harmonics[index].enabled = amplitude > 0.001f;
+            updateEnabled(index, amplitude > 0.001f);
+            bumpGeneration();
         }
     }
-    
+
     void setHarmonicAmplitude(int index, float amplitude)
     {
         if (index >= 0 && index < Constants::MAX_HARMONICS)
         {
             harmonics[index].amplitude = juce::jlimit(0.0f, 1.0f, amplitude);
-            harmonics[index].enabled = amplitude > 0.001f;
+            updateEnabled(index, amplitude > 0.001f);
+            bumpGeneration();
         }
     }
     
@@ -99,18 +108,26 @@ public:
         amount = juce::jlimit(0.0f, 1.0f, amount);
         for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
         {
-            harmonics[i].amplitude = harmonics[i].amplitude * (1.0f - amount) + 
+            harmonics[i].amplitude = harmonics[i].amplitude * (1.0f - amount) +
                                     target.harmonics[i].amplitude * amount;
-            harmonics[i].phase = harmonics[i].phase * (1.0f - amount) + 
+            harmonics[i].phase = harmonics[i].phase * (1.0f - amount) +
                                target.harmonics[i].phase * amount;
+            harmonics[i].enabled = harmonics[i].amplitude > 0.001f;
         }
+        rebuildActiveIndex();
+        bumpGeneration();
     }
-    
+
     void copyFrom(const HarmonicState& other)
     {
         harmonics = other.harmonics;
+        activeIndices = other.activeIndices;
+        activeCount = other.activeCount;
+        envelopeDecaySeconds = other.envelopeDecaySeconds;
+        envelopeSustainLevels = other.envelopeSustainLevels;
+        generation = other.generation;
     }
-    
+
     void clear()
     {
         for (auto& h : harmonics)
@@ -119,7 +136,55 @@ public:
             h.phase = 0.0f;
             h.enabled = false;
         }
+        activeCount = 0;
+        resetPartialEnvelopes();
+        bumpGeneration();
+    }
+
+    // Bulk restore for deserialization: adopt a raw harmonic array and
+    // rebuild the derived flags/index in one pass.
+    void restoreFrom(const std::array<HarmonicData, Constants::MAX_HARMONICS>& data)
+    {
+        harmonics = data;
+        for (auto& h : harmonics)
+            h.enabled = h.amplitude > 0.001f;
+        rebuildActiveIndex();
+        resetPartialEnvelopes();
+        bumpGeneration();
+    }
+
+    // Per-partial envelope shape (brightness decay and the like), shared by
+    // every voice rendering this state. A decay of 0 leaves a partial static.
+    void setPartialEnvelope(int index, float decaySeconds, float sustain)
+    {
+        if (index >= 0 && index < Constants::MAX_HARMONICS)
+        {
+            envelopeDecaySeconds[index] = juce::jmax(0.0f, decaySeconds);
+            envelopeSustainLevels[index] = juce::jlimit(0.0f, 1.0f, sustain);
+            bumpGeneration();
+        }
+    }
+
+    float getPartialEnvelopeDecay(int index) const
+    {
+        return (index >= 0 && index < Constants::MAX_HARMONICS) ? envelopeDecaySeconds[index] : 0.0f;
+    }
+
+    float getPartialEnvelopeSustain(int index) const
+    {
+        return (index >= 0 && index < Constants::MAX_HARMONICS) ? envelopeSustainLevels[index] : 1.0f;
+    }
+
+    void resetPartialEnvelopes()
+    {
+        envelopeDecaySeconds.fill(0.0f);
+        envelopeSustainLevels.fill(1.0f);
     }
+
+    // Compact, frequency-ordered list of the partials worth synthesizing, so
+    // the audio path scales with patch complexity instead of MAX_HARMONICS.
+    int getNumActivePartials() const { return activeCount; }
+    const std::array<int, Constants::MAX_HARMONICS>& getActivePartials() const { return activeIndices; }
     
     void loadPreset(const juce::String& presetName)
     {
@@ -156,9 +221,155 @@ public:
         
         for (auto& h : harmonics)
             h.enabled = h.amplitude > 0.001f;
+        rebuildActiveIndex();
+        bumpGeneration();
     }
-    
+
+    // Monotonic edit counter: every mutation stamps this state with a fresh
+    // globally unique value, so derived-data caches can key on one integer
+    // compare instead of hashing 128 partials. Copies keep the stamp — two
+    // states with equal generation are guaranteed identical.
+    uint64_t getGeneration() const { return generation; }
+
     std::array<HarmonicData, Constants::MAX_HARMONICS> harmonics;
+
+private:
+    std::array<int, Constants::MAX_HARMONICS> activeIndices {};
+    std::array<float, Constants::MAX_HARMONICS> envelopeDecaySeconds {};
+    std::array<float, Constants::MAX_HARMONICS> envelopeSustainLevels {};
+    uint64_t generation = 0;
+    int activeCount = 0;
+
+    static uint64_t nextGeneration()
+    {
+        static std::atomic<uint64_t> counter { 0 };
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    void bumpGeneration() { generation = nextGeneration(); }
+
+    void updateEnabled(int index, bool shouldBeEnabled)
+    {
+        if (harmonics[index].enabled == shouldBeEnabled)
+            return;
+
+        harmonics[index].enabled = shouldBeEnabled;
+
+        if (shouldBeEnabled)
+        {
+            // Insert keeping the list sorted by index (== by frequency)
+            int pos = activeCount;
+            while (pos > 0 && activeIndices[pos - 1] > index)
+            {
+                activeIndices[pos] = activeIndices[pos - 1];
+                --pos;
+            }
+            activeIndices[pos] = index;
+            ++activeCount;
+        }
+        else
+        {
+            for (int pos = 0; pos < activeCount; ++pos)
+            {
+                if (activeIndices[pos] == index)
+                {
+                    for (int j = pos; j < activeCount - 1; ++j)
+                        activeIndices[j] = activeIndices[j + 1];
+                    --activeCount;
+                    break;
+                }
+            }
+        }
+    }
+
+    void rebuildActiveIndex()
+    {
+        activeCount = 0;
+        for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+            if (harmonics[i].enabled)
+                activeIndices[activeCount++] = i;
+    }
+};
+
+//==============================================================================
+// DERIVED STATE CACHE
+//
+// Read-only products derived from a HarmonicState — currently the highest
+// active partial for band-limit clamping — computed once per distinct state
+// and shared by every consumer. Keyed by the state's generation counter, so
+// an unchanged patch costs one integer compare: repeated note-ons and
+// repeated publishes of the same state do zero derived recomputation.
+//==============================================================================
+class DerivedStateCache
+{
+public:
+    struct Derived
+    {
+        int highestActivePartial = -1; // clamp for per-note band limits
+        uint64_t generation = 0;
+    };
+
+    const Derived& get(const HarmonicState& state)
+    {
+        if (state.getGeneration() != derived.generation)
+            refresh(state);
+        return derived;
+    }
+
+private:
+    Derived derived;
+
+    void refresh(const HarmonicState& state)
+    {
+        derived.generation = state.getGeneration();
+
+        int numActive = state.getNumActivePartials();
+        derived.highestActivePartial = numActive > 0
+            ? state.getActivePartials()[numActive - 1] // list is frequency-ordered
+            : -1;
+    }
+};
+
+//==============================================================================
+// SINE WAVETABLE
+//
+// One table shared by every partial of every voice. A 4 KB table with a guard
+// sample for wrap-free linear interpolation stays in L1 for the whole render,
+// replacing a libm sin call per partial per sample.
+//==============================================================================
+class SineTable
+{
+public:
+    static const float* get()
+    {
+        static SineTable instance;
+        return instance.table.data();
+    }
+
+    static float lookup(const float* table, float phase) // phase in [0, 2pi)
+    {
+        float index = phase * (Constants::SINE_TABLE_SIZE / Constants::TWO_PI);
+        int i = static_cast<int>(index);
+        float frac = index - static_cast<float>(i);
+        return table[i] + frac * (table[i + 1] - table[i]);
+    }
+
+    static float lookupNormalized(const float* table, float phase) // phase in [0, 1)
+    {
+        float index = phase * Constants::SINE_TABLE_SIZE;
+        int i = static_cast<int>(index);
+        float frac = index - static_cast<float>(i);
+        return table[i] + frac * (table[i + 1] - table[i]);
+    }
+
+private:
+    SineTable()
+    {
+        for (int i = 0; i <= Constants::SINE_TABLE_SIZE; ++i)
+            table[i] = std::sin(Constants::TWO_PI * i / Constants::SINE_TABLE_SIZE);
+    }
+
+    std::array<float, Constants::SINE_TABLE_SIZE + 1> table {};
 };
 
 //==============================================================================
@@ -199,266 +410,2112 @@ private:
     }
 };
 
+//==============================================================================
+// SHARED PARTIAL BANK
+//
+// The per-block partial state that is identical across every voice: smoothing
+// targets and phase offsets for all 128 partials. The processor holds exactly
+// one and every oscillator reads it, so a voice's own mutable working set
+// shrinks to its phases, current amplitudes and ramp steps, all 16 voices'
+// hot state fits in L1 together, and the old "copy new targets into every
+// voice" walks collapse to a single write.
+//==============================================================================
+struct SharedPartialBank
+{
+    alignas(32) std::array<float, Constants::MAX_HARMONICS> targetAmplitudes {};
+    alignas(32) std::array<float, Constants::MAX_HARMONICS> phaseOffsets {};
+
+    // Highest partial worth visiting (from the derived-state cache); the
+    // per-block ramp pass stops here instead of walking all 128 slots.
+    int highestActivePartial = Constants::MAX_HARMONICS - 1;
+
+    // Sets the smoothing targets only — each voice's current amplitudes ramp
+    // towards them at block rate, so the UI can send sparse updates without
+    // clicks.
+    void setHarmonicState(const HarmonicState& state)
+    {
+        for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+        {
+            targetAmplitudes[i] = state.getHarmonicAmplitude(i);
+            phaseOffsets[i] = state.getHarmonic(i).phase / Constants::TWO_PI;
+        }
+    }
+
+    // Raw fast path for audio-rate morphing: target amplitudes only, no
+    // HarmonicState in between. Feeds the same smoothing ramps.
+    void setTargetAmplitudes(const float* targets)
+    {
+        juce::FloatVectorOperations::copy(targetAmplitudes.data(), targets, Constants::MAX_HARMONICS);
+    }
+
+    void setTargetAmplitude(int index, float amplitude)
+    {
+        if (index >= 0 && index < Constants::MAX_HARMONICS)
+            targetAmplitudes[index] = juce::jlimit(0.0f, 1.0f, amplitude);
+    }
+};
+
 //==============================================================================
 // HARMONIC OSCILLATOR
+//
+// The partial bank is laid out structure-of-arrays (separate phase / increment
+// / amplitude arrays) instead of an array of SineWaveGenerator objects, so the
+// summation kernel can run four partials at a time with independent
+// accumulators and the compiler can vectorize the inner loop (SSE/NEON).
+// Voice-invariant per-block state (targets, phase offsets) lives in the
+// processor's SharedPartialBank; only per-voice state is owned here.
 //==============================================================================
 class HarmonicOscillator
 {
 public:
-    void prepare(double sampleRate)
+    enum class Mode { wavetable, exactSin };
+
+    // independent: 128 per-partial phase accumulators (the historical path).
+    // sharedFundamental: one high-precision fundamental phase per voice;
+    // partial phases are derived per block as n * phase (plus the per-partial
+    // HarmonicData offset), so they can never drift apart, per-voice mutable
+    // state shrinks to a few bytes, and the wrap in the kernel is branchless.
+    enum class PhaseMode { sharedFundamental, independent };
+
+    // oscillatorBank: per-partial summation, O(partials x samples), lowest
+    // latency — the right choice for small patches.
+    // inverseFFT: one spectral frame per hop inverse-transformed and
+    // overlap-added, O(N log N) per frame regardless of partial count. Use
+    // the benchmark harness to measure the crossover on target hardware; it
+    // adds half an FFT frame of latency and is aimed at dense spectra.
+    enum class Engine { oscillatorBank, inverseFFT };
+
+    void prepare(double sr)
     {
-        for (auto& osc : oscillators)
-            osc.prepare(sampleRate);
+        sampleRate = sr;
+        sineTable = SineTable::get();
+        rampSamples = juce::jmax(1, static_cast<int>(SMOOTHING_TIME_SECONDS * sr));
+        prepareFFTEngine();
+        updatePhaseIncrements();
     }
-    
+
+    void setMode(Mode newMode) { mode = newMode; }
+    void setPhaseMode(PhaseMode newMode) { phaseMode = newMode; }
+    void setEngine(Engine newEngine) { engine = newEngine; }
+
     void reset()
     {
-        for (auto& osc : oscillators)
-            osc.reset();
+        phases.fill(0.0f);
+        fundamentalPhase = 0.0;
+        fftPartialPhases.fill(0.0f);
+        std::fill(olaRing.begin(), olaRing.end(), 0.0f);
+        olaWrite = olaRead = 0;
+        olaAvailable = 0;
     }
-    
+
     void setFrequency(float freq)
     {
         fundamentalFrequency = freq;
-        updateOscillatorFrequencies();
+        updatePhaseIncrements();
     }
-    
-    void setHarmonicState(const HarmonicState& state)
+
+    // Points the oscillator at the processor-owned shared bank. Defaults to
+    // an all-silent static bank so an unwired oscillator renders nothing.
+    void setSharedBank(const SharedPartialBank* newBank)
     {
-        for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
-        {
-            oscillators[i].setAmplitude(state.getHarmonicAmplitude(i));
-        }
+        bank = newBank != nullptr ? newBank : &silentBank();
     }
-    
-    float getNextSample()
+
+    // Optional per-partial gain vector (the voice's envelope matrix levels),
+    // multiplied into the smoothing targets each block. nullptr is neutral.
+    void setPartialGains(const float* gains) { partialGains = gains; }
+
+    // Sum of the current partial amplitudes as of the last rendered block —
+    // a cheap loudness proxy maintained by the ramp pass for free.
+    float getAmplitudeSum() const { return amplitudeSum; }
+
+    // Renders an entire block, overwriting dest. Partials are processed four
+    // abreast so the four phase recurrences and sine evaluations are
+    // independent and can be pipelined / vectorized.
+    void renderBlock(float* dest, int numSamples)
     {
-        float sample = 0.0f;
-        for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+        updateAmplitudeRamps(numSamples);
+
+        if (engine == Engine::inverseFFT)
+        {
+            renderBlockFFT(dest, numSamples);
+        }
+        else if (phaseMode == PhaseMode::sharedFundamental)
         {
-            if (oscillators[i].getNextSample() != 0.0f)
-                sample += oscillators[i].getNextSample();
+            if (mode == Mode::wavetable)
+                dispatchSharedKernel<true>(dest, numSamples);
+            else
+                dispatchSharedKernel<false>(dest, numSamples);
+        }
+        else
+        {
+            if (mode == Mode::wavetable)
+                renderBlockImpl<true>(dest, numSamples);
+            else
+                renderBlockImpl<false>(dest, numSamples);
         }
-        return sample * masterGain;
     }
-    
+
     void setGain(float gain) { masterGain = gain; }
-    
+
 private:
-    std::array<SineWaveGenerator, Constants::MAX_HARMONICS> oscillators;
+    static constexpr float SMOOTHING_TIME_SECONDS = 0.015f;
+
+    alignas(32) std::array<float, Constants::MAX_HARMONICS> phases {};
+    alignas(32) std::array<float, Constants::MAX_HARMONICS> increments {};
+    alignas(32) std::array<float, Constants::MAX_HARMONICS> amplitudes {};
+    alignas(32) std::array<float, Constants::MAX_HARMONICS> amplitudeSteps {};
+    std::array<int, Constants::MAX_HARMONICS> activeIndices {};
+    const SharedPartialBank* bank = &silentBank();
+    const float* partialGains = nullptr;
+    float amplitudeSum = 0.0f;
+    int highestLivePartial = Constants::MAX_HARMONICS - 1;
+    int activeCount = 0;
+    int rampSamples = 661;
+    int nyquistPartialLimit = Constants::MAX_HARMONICS;
+
+    double fundamentalPhase = 0.0;          // normalized [0, 1)
+    double fundamentalIncrementNorm = 0.0;  // fundamental / sampleRate
+
+    // IFFT engine state
+    static constexpr int FFT_ORDER = 10;
+    static constexpr int FFT_SIZE = 1 << FFT_ORDER;
+    static constexpr int FFT_HOP = FFT_SIZE / 2;
+    static constexpr int OLA_MASK = 2 * FFT_SIZE - 1;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> spectrum;
+    std::vector<float> window;
+    std::vector<float> olaRing;
+    std::array<float, Constants::MAX_HARMONICS> fftPartialPhases {};
+    int olaWrite = 0, olaRead = 0, olaAvailable = 0;
+
+    double sampleRate = 44100.0;
     float fundamentalFrequency = 440.0f;
     float masterGain = 0.5f;
-    
-    void updateOscillatorFrequencies()
+    Mode mode = Mode::wavetable;
+    PhaseMode phaseMode = PhaseMode::sharedFundamental;
+    Engine engine = Engine::oscillatorBank;
+    const float* sineTable = SineTable::get();
+
+    static float wrap01(double x) { return static_cast<float>(x - std::floor(x)); }
+
+    static const SharedPartialBank& silentBank()
     {
-        for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+        static const SharedPartialBank instance;
+        return instance;
+    }
+
+    // Once per block: compute a per-sample linear step towards each partial's
+    // target amplitude and rebuild the active index. A partial stays active
+    // while it is still ramping out, so deactivation fades instead of clicks.
+    void updateAmplitudeRamps(int numSamples)
+    {
+        activeCount = 0;
+        amplitudeSum = 0.0f;
+
+        // Stop at the highest partial that is either active in the shared
+        // bank or still ramping out locally, so a just-disabled top partial
+        // finishes its fade instead of being cut.
+        int limit = juce::jmin(nyquistPartialLimit,
+                               juce::jmax(bank->highestActivePartial, highestLivePartial) + 1);
+        highestLivePartial = -1;
+
+        for (int i = 0; i < limit; ++i)
         {
-            oscillators[i].setFrequency(fundamentalFrequency * (i + 1));
+            float current = amplitudes[i];
+            amplitudeSum += current;
+            float target = partialGains != nullptr ? bank->targetAmplitudes[i] * partialGains[i]
+                                                   : bank->targetAmplitudes[i];
+            float delta = target - current;
+
+            if (std::abs(delta) < 1.0e-6f)
+            {
+                amplitudes[i] = target;
+                amplitudeSteps[i] = 0.0f;
+
+                if (target < 0.001f)
+                    continue; // silent and not ramping — skip entirely
+            }
+            else
+            {
+                amplitudeSteps[i] = rampSamples > numSamples ? delta / static_cast<float>(rampSamples)
+                                                             : delta / static_cast<float>(numSamples);
+            }
+
+            activeIndices[activeCount++] = i;
+            highestLivePartial = i; // ascending loop: ends at the maximum
         }
     }
-};
 
-//==============================================================================
-// ENVELOPE PROCESSOR
-//==============================================================================
-class EnvelopeProcessor
-{
-public:
-    enum class State { Idle, Attack, Decay, Sustain, Release };
-    
-    void prepare(double sr) 
-    { 
-        sampleRate = sr; 
-        calculateRates();
-    }
-    
-    void noteOn() 
-    { 
-        currentState = State::Attack;
-        currentLevel = 0.0f;
+    template <bool useWavetable>
+    void renderBlockImpl(float* dest, int numSamples)
+    {
+        juce::FloatVectorOperations::clear(dest, numSamples);
+
+        const float* table = sineTable;
+
+        // Only the partials listed in the active index are synthesized, four
+        // abreast, so an organ patch pays for 3 partials instead of 128.
+        int k = 0;
+        for (; k + 4 <= activeCount; k += 4)
+        {
+            int i0 = activeIndices[k],     i1 = activeIndices[k + 1];
+            int i2 = activeIndices[k + 2], i3 = activeIndices[k + 3];
+
+            float p0 = phases[i0], inc0 = increments[i0], a0 = amplitudes[i0], st0 = amplitudeSteps[i0];
+            float p1 = phases[i1], inc1 = increments[i1], a1 = amplitudes[i1], st1 = amplitudeSteps[i1];
+            float p2 = phases[i2], inc2 = increments[i2], a2 = amplitudes[i2], st2 = amplitudeSteps[i2];
+            float p3 = phases[i3], inc3 = increments[i3], a3 = amplitudes[i3], st3 = amplitudeSteps[i3];
+
+            for (int s = 0; s < numSamples; ++s)
+            {
+                if constexpr (useWavetable)
+                    dest[s] += a0 * SineTable::lookup(table, p0) + a1 * SineTable::lookup(table, p1)
+                             + a2 * SineTable::lookup(table, p2) + a3 * SineTable::lookup(table, p3);
+                else
+                    dest[s] += a0 * std::sin(p0) + a1 * std::sin(p1)
+                             + a2 * std::sin(p2) + a3 * std::sin(p3);
+
+                p0 += inc0; p1 += inc1; p2 += inc2; p3 += inc3;
+                a0 += st0;  a1 += st1;  a2 += st2;  a3 += st3;
+
+                if (p0 >= Constants::TWO_PI) p0 -= Constants::TWO_PI;
+                if (p1 >= Constants::TWO_PI) p1 -= Constants::TWO_PI;
+                if (p2 >= Constants::TWO_PI) p2 -= Constants::TWO_PI;
+                if (p3 >= Constants::TWO_PI) p3 -= Constants::TWO_PI;
+            }
+
+            phases[i0] = p0; phases[i1] = p1; phases[i2] = p2; phases[i3] = p3;
+            amplitudes[i0] = a0; amplitudes[i1] = a1; amplitudes[i2] = a2; amplitudes[i3] = a3;
+        }
+
+        for (; k < activeCount; ++k)
+        {
+            int i = activeIndices[k];
+            float p = phases[i], inc = increments[i], a = amplitudes[i], st = amplitudeSteps[i];
+
+            for (int s = 0; s < numSamples; ++s)
+            {
+                if constexpr (useWavetable)
+                    dest[s] += a * SineTable::lookup(table, p);
+                else
+                    dest[s] += a * std::sin(p);
+
+                p += inc;
+                a += st;
+                if (p >= Constants::TWO_PI) p -= Constants::TWO_PI;
+            }
+
+            phases[i] = p;
+            amplitudes[i] = a;
+        }
+
+        juce::FloatVectorOperations::multiply(dest, masterGain, numSamples);
     }
-    
-    void noteOff() 
-    { 
-        currentState = State::Release; 
+
+    // Tier dispatch: one branch per block on the active-partial count, chosen
+    // after updateAmplitudeRamps has rebuilt the index. Everything below the
+    // branch has compile-time loop bounds.
+    template <bool useWavetable>
+    void dispatchSharedKernel(float* dest, int numSamples)
+    {
+        if (activeCount <= 8)
+            renderBlockSharedTier<8, useWavetable>(dest, numSamples);
+        else if (activeCount <= 32)
+            renderBlockSharedTier<32, useWavetable>(dest, numSamples);
+        else
+            renderBlockSharedImpl<useWavetable>(dest, numSamples);
     }
-    
-    void setAttack(float seconds) { attackTime = seconds; calculateRates(); }
-    void setDecay(float seconds) { decayTime = seconds; calculateRates(); }
-    void setSustain(float level) { sustainLevel = juce::jlimit(0.0f, 1.0f, level); }
-    void setRelease(float seconds) { releaseTime = seconds; calculateRates(); }
-    
-    float getNextSample()
+
+    // Tiered, compile-time-unrolled variant of the shared-fundamental kernel
+    // for small patches. Partials run in chunks of eight lanes whose loops all
+    // have constant trip counts, so the <=8 tier is a single fully unrolled,
+    // register-resident chunk (organ-class patches), and the <=32 tier is at
+    // most four of them. Lanes past the active count are padded silent rather
+    // than branched around; at most seven lanes of waste, and only in the
+    // last chunk.
+    template <int MaxPartials, bool useWavetable>
+    void renderBlockSharedTier(float* dest, int numSamples)
     {
-        switch (currentState)
+        constexpr int CHUNK = 8;
+        static_assert(MaxPartials % CHUNK == 0, "tiers are whole chunks");
+
+        juce::FloatVectorOperations::clear(dest, numSamples);
+
+        const float* table = sineTable;
+
+        for (int base = 0; base < MaxPartials && base < activeCount; base += CHUNK)
         {
-            case State::Idle:
-                return 0.0f;
-                
-            case State::Attack:
-                currentLevel += attackRate;
-                if (currentLevel >= 1.0f)
+            float p[CHUNK], inc[CHUNK], a[CHUNK], st[CHUNK];
+            int idx[CHUNK];
+
+            for (int lane = 0; lane < CHUNK; ++lane)
+            {
+                int k = base + lane;
+                if (k < activeCount)
                 {
-                    currentLevel = 1.0f;
-                    currentState = State::Decay;
+                    int i = activeIndices[k];
+                    idx[lane] = i;
+                    p[lane] = wrap01((i + 1) * fundamentalPhase + bank->phaseOffsets[i]);
+                    inc[lane] = wrap01((i + 1) * fundamentalIncrementNorm);
+                    a[lane] = amplitudes[i];
+                    st[lane] = amplitudeSteps[i];
                 }
-                break;
-                
-            case State::Decay:
-                currentLevel -= decayRate;
-                if (currentLevel <= sustainLevel)
+                else
                 {
-                    currentLevel = sustainLevel;
-                    currentState = State::Sustain;
+                    idx[lane] = -1;
+                    p[lane] = inc[lane] = a[lane] = st[lane] = 0.0f;
                 }
-                break;
-                
-            case State::Sustain:
-                currentLevel = sustainLevel;
-                break;
-                
-            case State::Release:
-                currentLevel -= releaseRate;
-                if (currentLevel <= 0.0f)
+            }
+
+            for (int s = 0; s < numSamples; ++s)
+            {
+                float sum = 0.0f;
+                for (int lane = 0; lane < CHUNK; ++lane)
                 {
-                    currentLevel = 0.0f;
-                    currentState = State::Idle;
+                    if constexpr (useWavetable)
+                        sum += a[lane] * SineTable::lookupNormalized(table, p[lane]);
+                    else
+                        sum += a[lane] * std::sin(Constants::TWO_PI * p[lane]);
+
+                    p[lane] += inc[lane];
+                    a[lane] += st[lane];
+                    p[lane] -= static_cast<float>(static_cast<int>(p[lane]));
                 }
-                break;
+                dest[s] += sum;
+            }
+
+            for (int lane = 0; lane < CHUNK; ++lane)
+                if (idx[lane] >= 0)
+                    amplitudes[idx[lane]] = a[lane];
         }
-        
-        return currentLevel;
+
+        fundamentalPhase += numSamples * fundamentalIncrementNorm;
+        fundamentalPhase -= std::floor(fundamentalPhase);
+
+        juce::FloatVectorOperations::multiply(dest, masterGain, numSamples);
     }
-    
-    bool isActive() const { return currentState != State::Idle; }
-    
-private:
-    State currentState = State::Idle;
-    double sampleRate = 44100.0;
-    float currentLevel = 0.0f;
-    
-    float attackTime = 0.01f;
-    float decayTime = 0.1f;
-    float sustainLevel = 0.7f;
-    float releaseTime = 0.5f;
-    
-    float attackRate = 0.0f;
-    float decayRate = 0.0f;
-    float releaseRate = 0.0f;
-    
-    void calculateRates()
+
+    // Shared-fundamental kernel: partial start phases and increments are
+    // derived from the single double-precision accumulator at block start
+    // (p_n = frac(n * phase + offset_n)), then advanced with a branchless
+    // wrap, so the 128 per-partial phase floats never accumulate drift.
+    template <bool useWavetable>
+    void renderBlockSharedImpl(float* dest, int numSamples)
     {
-        attackRate = 1.0f / (attackTime * sampleRate);
-        decayRate = (1.0f - sustainLevel) / (decayTime * sampleRate);
-        releaseRate = sustainLevel / (releaseTime * sampleRate);
-    }
-};
+        juce::FloatVectorOperations::clear(dest, numSamples);
 
-//==============================================================================
-// ADDITIVE VOICE
-//==============================================================================
-class AdditiveVoice : public juce::SynthesiserVoice
-{
-public:
-    bool canPlaySound(juce::SynthesiserSound*) override { return true; }
-    
-    void startNote(int midiNoteNumber, float velocity,
+        const float* table = sineTable;
+
+        int k = 0;
+        for (; k + 4 <= activeCount; k += 4)
+        {
+            int i0 = activeIndices[k],     i1 = activeIndices[k + 1];
+            int i2 = activeIndices[k + 2], i3 = activeIndices[k + 3];
+
+            float p0 = wrap01((i0 + 1) * fundamentalPhase + bank->phaseOffsets[i0]);
+            float p1 = wrap01((i1 + 1) * fundamentalPhase + bank->phaseOffsets[i1]);
+            float p2 = wrap01((i2 + 1) * fundamentalPhase + bank->phaseOffsets[i2]);
+            float p3 = wrap01((i3 + 1) * fundamentalPhase + bank->phaseOffsets[i3]);
+
+            float inc0 = wrap01((i0 + 1) * fundamentalIncrementNorm);
+            float inc1 = wrap01((i1 + 1) * fundamentalIncrementNorm);
+            float inc2 = wrap01((i2 + 1) * fundamentalIncrementNorm);
+            float inc3 = wrap01((i3 + 1) * fundamentalIncrementNorm);
+
+            float a0 = amplitudes[i0], st0 = amplitudeSteps[i0];
+            float a1 = amplitudes[i1], st1 = amplitudeSteps[i1];
+            float a2 = amplitudes[i2], st2 = amplitudeSteps[i2];
+            float a3 = amplitudes[i3], st3 = amplitudeSteps[i3];
+
+            for (int s = 0; s < numSamples; ++s)
+            {
+                if constexpr (useWavetable)
+                    dest[s] += a0 * SineTable::lookupNormalized(table, p0)
+                             + a1 * SineTable::lookupNormalized(table, p1)
+                             + a2 * SineTable::lookupNormalized(table, p2)
+                             + a3 * SineTable::lookupNormalized(table, p3);
+                else
+                    dest[s] += a0 * std::sin(Constants::TWO_PI * p0) + a1 * std::sin(Constants::TWO_PI * p1)
+                             + a2 * std::sin(Constants::TWO_PI * p2) + a3 * std::sin(Constants::TWO_PI * p3);
+
+                p0 += inc0; p1 += inc1; p2 += inc2; p3 += inc3;
+                a0 += st0;  a1 += st1;  a2 += st2;  a3 += st3;
+
+                p0 -= static_cast<float>(static_cast<int>(p0));
+                p1 -= static_cast<float>(static_cast<int>(p1));
+                p2 -= static_cast<float>(static_cast<int>(p2));
+                p3 -= static_cast<float>(static_cast<int>(p3));
+            }
+
+            amplitudes[i0] = a0; amplitudes[i1] = a1; amplitudes[i2] = a2; amplitudes[i3] = a3;
+        }
+
+        for (; k < activeCount; ++k)
+        {
+            int i = activeIndices[k];
+            float p = wrap01((i + 1) * fundamentalPhase + bank->phaseOffsets[i]);
+            float inc = wrap01((i + 1) * fundamentalIncrementNorm);
+            float a = amplitudes[i], st = amplitudeSteps[i];
+
+            for (int s = 0; s < numSamples; ++s)
+            {
+                if constexpr (useWavetable)
+                    dest[s] += a * SineTable::lookupNormalized(table, p);
+                else
+                    dest[s] += a * std::sin(Constants::TWO_PI * p);
+
+                p += inc;
+                a += st;
+                p -= static_cast<float>(static_cast<int>(p));
+            }
+
+            amplitudes[i] = a;
+        }
+
+        fundamentalPhase += numSamples * fundamentalIncrementNorm;
+        fundamentalPhase -= std::floor(fundamentalPhase);
+
+        juce::FloatVectorOperations::multiply(dest, masterGain, numSamples);
+    }
+
+    // IFFT engine: one spectral frame per hop. Each active partial deposits a
+    // complex amplitude at its nearest bin with its accumulated phase, the
+    // frame is inverse-transformed, Hann-windowed and overlap-added (50%
+    // hop, so the window pair sums to unity). Phases advance by the true
+    // partial frequency per hop, so pitch is exact even off-bin.
+    void prepareFFTEngine()
+    {
+        if (fft == nullptr)
+        {
+            fft = std::make_unique<juce::dsp::FFT>(FFT_ORDER);
+            spectrum.assign(2 * FFT_SIZE, 0.0f);
+            window.assign(FFT_SIZE, 0.0f);
+            olaRing.assign(OLA_MASK + 1, 0.0f);
+
+            for (int n = 0; n < FFT_SIZE; ++n)
+                window[n] = 0.5f * (1.0f - std::cos(Constants::TWO_PI * n / FFT_SIZE));
+        }
+    }
+
+    void renderBlockFFT(float* dest, int numSamples)
+    {
+        for (int s = 0; s < numSamples;)
+        {
+            if (olaAvailable == 0)
+                synthesizeFFTFrame();
+
+            int n = juce::jmin(numSamples - s, olaAvailable);
+            for (int i = 0; i < n; ++i)
+            {
+                int idx = (olaRead + i) & OLA_MASK;
+                dest[s + i] = olaRing[idx] * masterGain;
+                olaRing[idx] = 0.0f; // consumed — keep the ring clean for future overlap-adds
+            }
+
+            olaRead = (olaRead + n) & OLA_MASK;
+            olaAvailable -= n;
+            s += n;
+        }
+    }
+
+    void synthesizeFFTFrame()
+    {
+        std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+
+        const float binScale = FFT_SIZE * 0.5f;
+        const double hopSeconds = FFT_HOP / sampleRate;
+
+        for (int k = 0; k < activeCount; ++k)
+        {
+            int i = activeIndices[k];
+            double freq = fundamentalFrequency * (i + 1);
+            int bin = static_cast<int>(freq * FFT_SIZE / sampleRate + 0.5);
+
+            float amp = amplitudes[i] * binScale;
+
+            // The bank kernels advance the amplitude ramps per sample; here
+            // the frame is the unit of time, so advance one hop per frame,
+            // clamped at the target because a large block spans several hops
+            // while the steps are recomputed only at block rate.
+            float target = partialGains != nullptr ? bank->targetAmplitudes[i] * partialGains[i]
+                                                   : bank->targetAmplitudes[i];
+            float next = amplitudes[i] + amplitudeSteps[i] * static_cast<float>(FFT_HOP);
+            amplitudes[i] = amplitudeSteps[i] > 0.0f ? juce::jmin(next, target)
+                                                     : juce::jmax(next, target);
+
+            if (bin <= 0 || bin >= FFT_SIZE / 2)
+                continue;
+
+            // sin(x) == cos(x - pi/2), and the bin convention is cosine-based
+            float ph = Constants::TWO_PI * (fftPartialPhases[i] + bank->phaseOffsets[i]) - Constants::PI * 0.5f;
+            spectrum[2 * bin] += amp * std::cos(ph);
+            spectrum[2 * bin + 1] += amp * std::sin(ph);
+
+            fftPartialPhases[i] = wrap01(fftPartialPhases[i] + freq * hopSeconds);
+        }
+
+        fft->performRealOnlyInverseTransform(spectrum.data());
+
+        for (int n = 0; n < FFT_SIZE; ++n)
+            olaRing[(olaWrite + n) & OLA_MASK] += spectrum[n] * window[n];
+
+        olaWrite = (olaWrite + FFT_HOP) & OLA_MASK;
+        olaAvailable += FFT_HOP;
+    }
+
+    void updatePhaseIncrements()
+    {
+        float baseIncrement = Constants::TWO_PI * fundamentalFrequency / static_cast<float>(sampleRate);
+        for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+            increments[i] = baseIncrement * (i + 1);
+
+        fundamentalIncrementNorm = fundamentalFrequency / sampleRate;
+
+        // Band-limiting: partials at or above Nyquist only alias, so the
+        // active index (frequency-ordered) hard-stops below them. For high
+        // notes this shrinks the partial count by itself.
+        double nyquist = sampleRate * 0.5;
+        nyquistPartialLimit = fundamentalFrequency > 0.0f
+            ? juce::jlimit(0, Constants::MAX_HARMONICS, static_cast<int>(nyquist / fundamentalFrequency))
+            : Constants::MAX_HARMONICS;
+    }
+};
+
+//==============================================================================
+// ENVELOPE PROCESSOR
+//==============================================================================
+// Block-oriented ADSR with one-pole exponential segments. Each timed segment
+// is y[n] = base + y[n-1] * coef with coefficients precomputed into a small
+// table whenever a time parameter changes, so the per-sample work is a single
+// multiply-add. renderBlock fills a ramp buffer in one pass: the number of
+// samples left in the current segment is solved analytically from the one-pole
+// recurrence, so state transitions are checked once per segment per block
+// instead of once per sample.
+class EnvelopeProcessor
+{
+public:
+    enum class State { Idle, Attack, Decay, Sustain, Release };
+
+    void prepare(double sr)
+    {
+        sampleRate = sr;
+        calculateCoefficients();
+    }
+
+    void noteOn()
+    {
+        currentState = State::Attack;
+        currentLevel = 0.0f;
+    }
+
+    void noteOff()
+    {
+        currentState = State::Release;
+    }
+
+    void setAttack(float seconds) { attackTime = seconds; calculateCoefficients(); }
+    void setDecay(float seconds) { decayTime = seconds; calculateCoefficients(); }
+    void setSustain(float level) { sustainLevel = juce::jlimit(0.0f, 1.0f, level); calculateCoefficients(); }
+    void setRelease(float seconds) { releaseTime = seconds; calculateCoefficients(); }
+
+    // Fills dest with the envelope ramp for this block. Segment inner loops
+    // are pure multiply-adds with no branches; transitions happen between
+    // them.
+    void renderBlock(float* dest, int numSamples)
+    {
+        int i = 0;
+        while (i < numSamples)
+        {
+            switch (currentState)
+            {
+                case State::Idle:
+                    juce::FloatVectorOperations::clear(dest + i, numSamples - i);
+                    currentLevel = 0.0f;
+                    i = numSamples;
+                    break;
+
+                case State::Sustain:
+                    juce::FloatVectorOperations::fill(dest + i, sustainLevel, numSamples - i);
+                    currentLevel = sustainLevel;
+                    i = numSamples;
+                    break;
+
+                case State::Attack:
+                    i += runSegment(segments[ATTACK], 1.0f, dest, i, numSamples);
+                    if (currentLevel >= 1.0f)
+                    {
+                        currentLevel = 1.0f;
+                        currentState = State::Decay;
+                    }
+                    break;
+
+                case State::Decay:
+                    i += runSegment(segments[DECAY], sustainLevel, dest, i, numSamples);
+                    if (currentLevel <= sustainLevel)
+                    {
+                        currentLevel = sustainLevel;
+                        currentState = State::Sustain;
+                    }
+                    break;
+
+                case State::Release:
+                    i += runSegment(segments[RELEASE], IDLE_THRESHOLD, dest, i, numSamples);
+                    if (currentLevel <= IDLE_THRESHOLD)
+                    {
+                        currentLevel = 0.0f;
+                        currentState = State::Idle;
+                    }
+                    break;
+            }
+        }
+    }
+
+    bool isActive() const { return currentState != State::Idle; }
+    State getState() const { return currentState; }
+    float getCurrentLevel() const { return currentLevel; }
+
+    // Advances the envelope as if numSamples had been rendered, without
+    // producing output — used when a whole block is gated as inaudible.
+    void skipSamples(int numSamples)
+    {
+        if (currentState == State::Release)
+        {
+            const Segment& s = segments[RELEASE];
+            // Closed form of n one-pole steps toward the asymptote.
+            float asymptote = s.base / (1.0f - s.coef);
+            currentLevel = asymptote + (currentLevel - asymptote)
+                                           * std::pow(s.coef, static_cast<float>(numSamples));
+            if (currentLevel <= IDLE_THRESHOLD)
+            {
+                currentLevel = 0.0f;
+                currentState = State::Idle;
+            }
+        }
+    }
+
+private:
+    enum SegmentIndex { ATTACK = 0, DECAY, RELEASE, NUM_SEGMENTS };
+
+    struct Segment
+    {
+        float coef = 0.0f;
+        float base = 0.0f;
+    };
+
+    // Overshoot ratios (Redmon-style): attack aims slightly past 1 so it
+    // actually arrives; decay/release aim just below their target for a
+    // near-true exponential tail.
+    static constexpr float ATTACK_RATIO = 0.3f;
+    static constexpr float DECAY_RATIO = 0.0001f;
+    static constexpr float IDLE_THRESHOLD = 1.0e-4f;
+
+    State currentState = State::Idle;
+    double sampleRate = 44100.0;
+    float currentLevel = 0.0f;
+
+    float attackTime = 0.01f;
+    float decayTime = 0.1f;
+    float sustainLevel = 0.7f;
+    float releaseTime = 0.5f;
+
+    std::array<Segment, NUM_SEGMENTS> segments {};
+
+    static Segment makeSegment(float seconds, double sampleRate, float ratio, float target)
+    {
+        Segment s;
+        float lengthSamples = juce::jmax(1.0f, seconds * static_cast<float>(sampleRate));
+        s.coef = std::exp(-std::log((1.0f + ratio) / ratio) / lengthSamples);
+        s.base = target * (1.0f - s.coef);
+        return s;
+    }
+
+    void calculateCoefficients()
+    {
+        segments[ATTACK] = makeSegment(attackTime, sampleRate, ATTACK_RATIO, 1.0f + ATTACK_RATIO);
+        segments[DECAY] = makeSegment(decayTime, sampleRate, DECAY_RATIO, sustainLevel - DECAY_RATIO);
+        segments[RELEASE] = makeSegment(releaseTime, sampleRate, DECAY_RATIO, -DECAY_RATIO);
+    }
+
+    // Runs one segment until it reaches `threshold` or the block ends,
+    // whichever is first, and returns the number of samples written. The
+    // sample count to the threshold crossing is solved from the recurrence
+    // up front so the loop body carries no comparisons.
+    int runSegment(const Segment& s, float threshold, float* dest, int offset, int numSamples)
+    {
+        float asymptote = s.base / (1.0f - s.coef);
+        int remaining = numSamples - offset;
+        int count = remaining;
+
+        float gap = currentLevel - asymptote;
+        float targetGap = threshold - asymptote;
+        if (std::abs(gap) > 1.0e-12f)
+        {
+            float stepsToTarget = std::log(targetGap / gap) / std::log(s.coef);
+            if (stepsToTarget < static_cast<float>(remaining))
+                count = juce::jmax(1, static_cast<int>(std::ceil(stepsToTarget)));
+        }
+
+        float level = currentLevel;
+        for (int n = 0; n < count; ++n)
+        {
+            level = s.base + level * s.coef;
+            dest[offset + n] = level;
+        }
+        currentLevel = level;
+        return count;
+    }
+};
+
+//==============================================================================
+// PER-PARTIAL ENVELOPE MATRIX
+//
+// Per-partial amplitude envelopes in structure-of-arrays layout, so the 128
+// envelopes of a voice advance with one multiply-add pass per block — there is
+// no per-envelope state machine anywhere. The shape (one-pole coefficient and
+// base per partial) is derived from the shared HarmonicState once and used by
+// every voice; a voice only owns its level array. The block-rate levels feed
+// the oscillator's per-sample smoothing ramps, so the result stays click-free
+// while the added cost is two 128-wide passes per voice per block.
+//==============================================================================
+class PartialEnvelopeMatrix
+{
+public:
+    struct Shape
+    {
+        // The pole is stored per sample (as the exponent -1 / (decay * rate))
+        // because juce::Synthesiser splits blocks at every MIDI event: baking
+        // coefficients for the full host block would make the envelopes decay
+        // once per split instead of once per block. A static partial gets a
+        // zero exponent, which yields coef 1 / base 0 for any chunk length.
+        alignas(32) std::array<float, Constants::MAX_HARMONICS> perSampleExponent {};
+        alignas(32) std::array<float, Constants::MAX_HARMONICS> sustain {};
+        bool anyActive = false;
+
+        // Rebuilt only when the harmonic state or sample rate changes —
+        // never on the per-block path.
+        void update(const HarmonicState& state, double sampleRate)
+        {
+            anyActive = false;
+            for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+            {
+                float decay = state.getPartialEnvelopeDecay(i);
+                perSampleExponent[i] = decay > 0.0f
+                    ? -1.0f / (decay * static_cast<float>(sampleRate))
+                    : 0.0f;
+                sustain[i] = state.getPartialEnvelopeSustain(i);
+                anyActive = anyActive || decay > 0.0f;
+            }
+            cachedLength = 0;
+        }
+
+        // Called by the synthesiser on the audio thread once per render
+        // segment, before any voice is dispatched — voices (which the render
+        // pool may run on worker threads) only read the cache. Coefficients
+        // are cached on the length, so the exp() pass reruns only when the
+        // split length actually changes.
+        void refreshChunk(int numSamples) const
+        {
+            if (numSamples == cachedLength)
+                return;
+
+            cachedLength = numSamples;
+            for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+            {
+                float c = std::exp(perSampleExponent[i] * static_cast<float>(numSamples));
+                coef[i] = c;
+                base[i] = sustain[i] * (1.0f - c);
+            }
+        }
+
+        // Chunk-length cache; mutable because voices hold the shape const.
+        alignas(32) mutable std::array<float, Constants::MAX_HARMONICS> coef {};
+        alignas(32) mutable std::array<float, Constants::MAX_HARMONICS> base {};
+        mutable int cachedLength = 0;
+    };
+
+    void noteOn() { levels.fill(1.0f); }
+
+    // The whole matrix advances one chunk in a single vectorizable pass.
+    // The shape's chunk cache must already be refreshed for this segment's
+    // length — this may run on a worker thread and must not write it.
+    void advanceBlock(const Shape& shape)
+    {
+        for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+            levels[i] = shape.base[i] + levels[i] * shape.coef[i];
+    }
+
+    const float* getLevels() const { return levels.data(); }
+
+private:
+    alignas(32) std::array<float, Constants::MAX_HARMONICS> levels {};
+};
+
+//==============================================================================
+// ADDITIVE VOICE
+//==============================================================================
+class AdditiveVoice : public juce::SynthesiserVoice
+{
+public:
+    bool canPlaySound(juce::SynthesiserSound*) override { return true; }
+    
+    void startNote(int midiNoteNumber, float velocity,
                    juce::SynthesiserSound*, int) override
     {
-        currentVelocity = velocity;
-        float freq = 440.0f * std::pow(2.0f, (midiNoteNumber - 69) / 12.0f);
-        oscillator.setFrequency(freq);
-        envelope.noteOn();
+        currentVelocity = velocity;
+        float freq = 440.0f * std::pow(2.0f, (midiNoteNumber - 69) / 12.0f);
+        oscillator.setFrequency(freq);
+        partialEnvelopes.noteOn();
+        envelope.noteOn();
+    }
+    
+    void stopNote(float, bool allowTailOff) override
+    {
+        if (allowTailOff)
+            envelope.noteOff();
+        else
+            clearCurrentNote();
+    }
+    
+    void pitchWheelMoved(int) override {}
+    void controllerMoved(int, int) override {}
+    
+    void renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
+                        int startSample, int numSamples) override
+    {
+        if (!envelope.isActive())
+        {
+            clearCurrentNote();
+            return;
+        }
+
+        // Silence gate: in Release the envelope only decays, so its current
+        // level bounds the whole block. Long release tails stop costing full
+        // partial synthesis as soon as they drop below audibility.
+        if (envelope.getState() == EnvelopeProcessor::State::Release
+            && envelope.getCurrentLevel() * currentVelocity < SILENCE_EPSILON)
+        {
+            envelope.skipSamples(numSamples);
+            if (!envelope.isActive())
+                clearCurrentNote();
+            return;
+        }
+
+        // Advance the per-partial envelope matrix once per block and hand the
+        // levels to the oscillator as target gains; the per-sample smoothing
+        // ramps interpolate them, so this adds no per-sample work.
+        if (partialEnvelopeShape != nullptr && partialEnvelopeShape->anyActive)
+        {
+            partialEnvelopes.advanceBlock(*partialEnvelopeShape);
+            oscillator.setPartialGains(partialEnvelopes.getLevels());
+        }
+        else
+        {
+            oscillator.setPartialGains(nullptr);
+        }
+
+        // Synthesize into a contiguous scratch block, shape it with the
+        // envelope ramp (velocity folded into the mix gain), then mix into
+        // the output with one vectorized add per channel. The old per-sample
+        // addSample loop paid a bounds check per sample per channel.
+        while (numSamples > 0)
+        {
+            int chunk = juce::jmin(numSamples, static_cast<int>(scratchBuffer.size()));
+
+            oscillator.renderBlock(scratchBuffer.data(), chunk);
+            envelope.renderBlock(envelopeBuffer.data(), chunk);
+
+            juce::FloatVectorOperations::multiply(scratchBuffer.data(), envelopeBuffer.data(), chunk);
+
+            for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch)
+                juce::FloatVectorOperations::addWithMultiply(outputBuffer.getWritePointer(ch, startSample),
+                                                             scratchBuffer.data(), currentVelocity, chunk);
+
+            startSample += chunk;
+            numSamples -= chunk;
+        }
+    }
+
+    void prepare(double sampleRate, int maxBlockSize)
+    {
+        oscillator.prepare(sampleRate);
+        envelope.prepare(sampleRate);
+        scratchBuffer.assign(static_cast<size_t>(juce::jmax(maxBlockSize, 64)), 0.0f);
+        envelopeBuffer.assign(scratchBuffer.size(), 0.0f);
+    }
+    
+    void setSharedBank(const SharedPartialBank* bank)
+    {
+        oscillator.setSharedBank(bank);
+    }
+
+
+    void setEnvelope(float attack, float decay, float sustain, float release)
+    {
+        envelope.setAttack(attack);
+        envelope.setDecay(decay);
+        envelope.setSustain(sustain);
+        envelope.setRelease(release);
+    }
+
+    void setSynthesisEngine(HarmonicOscillator::Engine engine)
+    {
+        oscillator.setEngine(engine);
+    }
+
+    void setGain(float gain)
+    {
+        oscillator.setGain(gain);
+    }
+
+    // The shape lives in the processor and is shared by all voices.
+    void setPartialEnvelopeShape(const PartialEnvelopeMatrix::Shape* shape)
+    {
+        partialEnvelopeShape = shape;
+    }
+
+    // Loudness proxy for the polyphony governor: envelope level x velocity x
+    // summed partial amplitudes. All three factors are already maintained.
+    float getAudibility() const
+    {
+        return envelope.getCurrentLevel() * currentVelocity * oscillator.getAmplitudeSum();
+    }
+
+    bool isReleasing() const { return envelope.getState() == EnvelopeProcessor::State::Release; }
+
+private:
+    static constexpr float SILENCE_EPSILON = 1.0e-4f; // -80 dB
+
+    HarmonicOscillator oscillator;
+    EnvelopeProcessor envelope;
+    PartialEnvelopeMatrix partialEnvelopes;
+    const PartialEnvelopeMatrix::Shape* partialEnvelopeShape = nullptr;
+    float currentVelocity = 1.0f;
+    std::vector<float> scratchBuffer = std::vector<float>(512, 0.0f);
+    std::vector<float> envelopeBuffer = std::vector<float>(512, 0.0f);
+};
+
+//==============================================================================
+// ADDITIVE SOUND
+//==============================================================================
+class AdditiveSound : public juce::SynthesiserSound
+{
+public:
+    bool appliesToNote(int) override { return true; }
+    bool appliesToChannel(int) override { return true; }
+};
+
+//==============================================================================
+// VOICE RENDER POOL
+//
+// Opt-in worker pool that partitions voice rendering across a few
+// high-priority threads. Each worker accumulates into its own pre-allocated
+// buffer and the audio thread does a final vectorized mixdown, so the only
+// shared hot-path state is a job generation counter and an atomic voice
+// index — no locks, no allocation. Workers spin briefly between
+// back-to-back blocks and park on their event when the transport is idle.
+//==============================================================================
+class VoiceRenderPool
+{
+public:
+    ~VoiceRenderPool() { shutdown(); }
+
+    void prepare(int numChannels, int maxBlockSize, int numWorkerThreads)
+    {
+        shutdown();
+
+        numWorkers = juce::jlimit(1, MAX_WORKERS, numWorkerThreads + 1); // +1: the audio thread works too
+
+        for (int w = 0; w < numWorkers; ++w)
+            accumBuffers[w].setSize(numChannels, maxBlockSize);
+
+        running.store(true, std::memory_order_release);
+
+        for (int w = 1; w < numWorkers; ++w)
+        {
+            workers[w] = std::make_unique<Worker>(*this, w);
+            workers[w]->startThread(juce::Thread::Priority::highest);
+        }
+    }
+
+    void shutdown()
+    {
+        running.store(false, std::memory_order_release);
+
+        for (auto& worker : workers)
+        {
+            if (worker != nullptr)
+                worker->stopThread(500);
+            worker = nullptr;
+        }
+    }
+
+    // Audio thread. Renders all voices of synth into outputBuffer using every
+    // worker (including the calling thread), then mixes the partial sums.
+    void render(juce::Synthesiser& synth, juce::AudioBuffer<float>& outputBuffer,
+                int startSample, int numSamples)
+    {
+        job.synth = &synth;
+        job.numSamples = numSamples;
+        nextVoice.store(0, std::memory_order_relaxed);
+        uint64_t thisJob = generation.fetch_add(1, std::memory_order_release) + 1;
+
+        for (int w = 1; w < numWorkers; ++w)
+            workers[w]->notify(); // no-op while they are still spinning
+
+        renderShare(0);
+
+        // Bounded wait on the order of the block deadline: a worker that has
+        // not tagged this job by then is stalled, and its buffer is skipped
+        // below rather than mixed half-written. Completions carry the job
+        // generation, so a late one lands on its own (old) tag and can
+        // neither satisfy nor corrupt a later job's wait.
+        double synthRate = synth.getSampleRate();
+        double waitSeconds = synthRate > 0.0 ? 2.0 * numSamples / synthRate : 0.01;
+        auto deadline = juce::Time::getHighResolutionTicks()
+                      + static_cast<int64_t>(waitSeconds * static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()));
+
+        int spins = 0;
+        while (!allWorkersDone(thisJob))
+        {
+            if (++spins > SPINS_BEFORE_YIELD)
+            {
+                std::this_thread::yield();
+                if (juce::Time::getHighResolutionTicks() > deadline)
+                    break;
+            }
+        }
+
+        for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch)
+            outputBuffer.addFrom(ch, startSample, accumBuffers[0], ch, 0, numSamples);
+
+        for (int w = 1; w < numWorkers; ++w)
+            if (doneGenerations[w].load(std::memory_order_acquire) == thisJob)
+                for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch)
+                    outputBuffer.addFrom(ch, startSample, accumBuffers[w], ch, 0, numSamples);
+    }
+
+private:
+    static constexpr int MAX_WORKERS = 32; // realtime uses a few; offline farm nodes use them all
+    static constexpr int SPINS_BEFORE_YIELD = 2000;
+
+    class Worker : public juce::Thread
+    {
+    public:
+        // The generation baseline is captured here, before startThread, while
+        // no render() can be concurrent — baselining inside run() could adopt
+        // a generation the audio thread already bumped, skip that job and
+        // leave pendingWorkers stuck above zero.
+        Worker(VoiceRenderPool& p, int index)
+            : juce::Thread("VoiceRender" + juce::String(index)), pool(p), workerIndex(index),
+              lastGeneration(p.generation.load(std::memory_order_acquire)) {}
+
+        void run() override
+        {
+            int spins = 0;
+
+            while (!threadShouldExit() && pool.running.load(std::memory_order_acquire))
+            {
+                uint64_t g = pool.generation.load(std::memory_order_acquire);
+                if (g == lastGeneration)
+                {
+                    // Spin/block hybrid: a short spin catches back-to-back
+                    // blocks, then the thread parks on its event so an idle
+                    // transport costs no CPU. render() notifies on new work
+                    // and the event latches, so a notify between the
+                    // generation check and the wait is never lost.
+                    if (++spins > SPINS_BEFORE_YIELD)
+                    {
+                        wait(-1);
+                        spins = 0;
+                    }
+                    continue;
+                }
+
+                lastGeneration = g;
+                spins = 0;
+                pool.renderShare(workerIndex);
+                pool.doneGenerations[workerIndex].store(g, std::memory_order_release);
+            }
+        }
+
+    private:
+        VoiceRenderPool& pool;
+        int workerIndex;
+        uint64_t lastGeneration;
+    };
+
+    struct Job
+    {
+        juce::Synthesiser* synth = nullptr;
+        int numSamples = 0;
+    };
+
+    void renderShare(int workerIndex)
+    {
+        auto& accum = accumBuffers[workerIndex];
+        accum.clear();
+
+        int numVoices = job.synth->getNumVoices();
+        for (int v = nextVoice.fetch_add(1, std::memory_order_relaxed); v < numVoices;
+             v = nextVoice.fetch_add(1, std::memory_order_relaxed))
+        {
+            job.synth->getVoice(v)->renderNextBlock(accum, 0, job.numSamples);
+        }
+    }
+
+    bool allWorkersDone(uint64_t thisJob) const
+    {
+        for (int w = 1; w < numWorkers; ++w)
+            if (doneGenerations[w].load(std::memory_order_acquire) != thisJob)
+                return false;
+        return true;
+    }
+
+    std::array<juce::AudioBuffer<float>, MAX_WORKERS> accumBuffers;
+    std::array<std::unique_ptr<Worker>, MAX_WORKERS> workers;
+    Job job;
+    int numWorkers = 1;
+    std::atomic<uint64_t> generation { 0 };
+    std::array<std::atomic<uint64_t>, MAX_WORKERS> doneGenerations {};
+    std::atomic<int> nextVoice { 0 };
+    std::atomic<bool> running { false };
+};
+
+//==============================================================================
+// ADDITIVE SYNTHESISER
+//
+// Synthesiser subclass whose renderVoices can hand the voice loop to the
+// VoiceRenderPool. MIDI dispatch and event-boundary splitting stay in the
+// juce::Synthesiser base class.
+//==============================================================================
+class AdditiveSynthesiser : public juce::Synthesiser
+{
+public:
+    void setRenderPool(VoiceRenderPool* pool) { renderPool = pool; }
+    void setPartialEnvelopeShape(const PartialEnvelopeMatrix::Shape* shape) { envelopeShape = shape; }
+
+protected:
+    void renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) override
+    {
+        // Refresh the shared envelope chunk cache here, on the audio thread,
+        // before any voice runs: the pool renders voices on worker threads
+        // concurrently and they must only ever read it.
+        if (envelopeShape != nullptr && envelopeShape->anyActive)
+            envelopeShape->refreshChunk(numSamples);
+
+        if (renderPool != nullptr)
+            renderPool->render(*this, buffer, startSample, numSamples);
+        else
+            juce::Synthesiser::renderVoices(buffer, startSample, numSamples);
+    }
+
+private:
+    VoiceRenderPool* renderPool = nullptr;
+    const PartialEnvelopeMatrix::Shape* envelopeShape = nullptr;
+};
+
+//==============================================================================
+// PRESET BANK
+//
+// A single memory-mapped bank file holding every preset in the same fixed
+// binary layout as HarmonicState::harmonics. Lookup goes through a sorted
+// (hash, index) table built once at open, so browsing presets during a show
+// never allocates or touches the filesystem beyond the initial mapping.
+//
+// File layout: BankHeader, then numPresets x PresetRecord.
+//==============================================================================
+class PresetBank
+{
+public:
+    static constexpr uint32_t BANK_MAGIC = 0x41535042; // "ASPB"
+    static constexpr uint32_t BANK_VERSION = 1;
+    static constexpr int PRESET_NAME_LENGTH = 48;
+
+    struct BankHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t numPresets;
+        uint32_t reserved;
+    };
+
+    struct PresetRecord
+    {
+        char name[PRESET_NAME_LENGTH]; // zero-padded UTF-8
+        std::array<HarmonicData, Constants::MAX_HARMONICS> harmonics;
+    };
+
+    bool open(const juce::File& file)
+    {
+        close();
+
+        if (!file.existsAsFile())
+            return false;
+
+        mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+
+        if (mapping->getData() == nullptr || mapping->getSize() < sizeof(BankHeader))
+        {
+            close();
+            return false;
+        }
+
+        const auto* header = static_cast<const BankHeader*>(mapping->getData());
+        if (header->magic != BANK_MAGIC || header->version != BANK_VERSION
+            || mapping->getSize() < sizeof(BankHeader) + header->numPresets * sizeof(PresetRecord))
+        {
+            close();
+            return false;
+        }
+
+        numPresets = static_cast<int>(header->numPresets);
+        records = reinterpret_cast<const PresetRecord*>(static_cast<const char*>(mapping->getData()) + sizeof(BankHeader));
+
+        // One-time index build — the only allocation this class ever does.
+        index.clear();
+        index.reserve(static_cast<size_t>(numPresets));
+        for (int i = 0; i < numPresets; ++i)
+            index.push_back({ hashName(records[i].name), i });
+        std::sort(index.begin(), index.end());
+
+        return true;
+    }
+
+    void close()
+    {
+        mapping = nullptr;
+        records = nullptr;
+        numPresets = 0;
+        index.clear();
+    }
+
+    bool isOpen() const { return records != nullptr; }
+    int getNumPresets() const { return numPresets; }
+
+    const PresetRecord* getPreset(int i) const
+    {
+        return (i >= 0 && i < numPresets) ? &records[i] : nullptr;
+    }
+
+    // O(log n) over the hash table, allocation-free.
+    const PresetRecord* findPreset(const char* name) const
+    {
+        uint32_t hash = hashName(name);
+        auto it = std::lower_bound(index.begin(), index.end(), std::pair<uint32_t, int>(hash, 0));
+
+        for (; it != index.end() && it->first == hash; ++it)
+            if (std::strncmp(records[it->second].name, name, PRESET_NAME_LENGTH) == 0)
+                return &records[it->second];
+
+        return nullptr;
+    }
+
+    bool loadInto(const char* name, HarmonicState& state) const
+    {
+        if (const auto* record = findPreset(name))
+        {
+            state.restoreFrom(record->harmonics); // straight from the mapping, no parsing
+            return true;
+        }
+        return false;
+    }
+
+    // Offline utility for building a bank from a set of named states.
+    static bool writeBank(const juce::File& file,
+                          const std::vector<std::pair<juce::String, std::array<HarmonicData, Constants::MAX_HARMONICS>>>& presets)
+    {
+        juce::MemoryBlock blob;
+
+        BankHeader header { BANK_MAGIC, BANK_VERSION, static_cast<uint32_t>(presets.size()), 0 };
+        blob.append(&header, sizeof(header));
+
+        for (const auto& preset : presets)
+        {
+            PresetRecord record {};
+            std::strncpy(record.name, preset.first.toRawUTF8(), PRESET_NAME_LENGTH - 1);
+            record.harmonics = preset.second;
+            blob.append(&record, sizeof(record));
+        }
+
+        return file.replaceWithData(blob.getData(), blob.getSize());
+    }
+
+private:
+    static uint32_t hashName(const char* name) // FNV-1a
+    {
+        uint32_t hash = 2166136261u;
+        for (int i = 0; i < PRESET_NAME_LENGTH && name[i] != 0; ++i)
+        {
+            hash ^= static_cast<uint8_t>(name[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    std::unique_ptr<juce::MemoryMappedFile> mapping;
+    const PresetRecord* records = nullptr;
+    int numPresets = 0;
+    std::vector<std::pair<uint32_t, int>> index;
+};
+
+//==============================================================================
+// TIMBRE SEQUENCE
+//
+// Streaming playback of pre-designed timbre trajectories: a sequence file
+// stores keyframed harmonic states as timestamped deltas against an all-zero
+// initial state, so an hour of slowly evolving timbre is a few kilobytes
+// instead of 3600 full snapshots. The file is memory-mapped and a background
+// thread reconstructs full keyframe snapshots into a small lock-free ring a
+// few frames ahead of the playhead; the audio thread interpolates between
+// the two keyframes straddling the block and feeds the result into the same
+// block-rate morph path as the morphing engine. Memory footprint is fixed
+// (the mapping plus eight decoded frames) and the audio thread never
+// allocates or touches the file.
+//
+// File layout: SequenceHeader, then numKeyframes variable-length keyframes,
+// each a KeyframeHeader followed by numChanges x PartialChange.
+//==============================================================================
+class TimbreSequencePlayer : private juce::Thread
+{
+public:
+    static constexpr uint32_t SEQUENCE_MAGIC = 0x41535453; // "ASTS"
+    static constexpr uint32_t SEQUENCE_VERSION = 1;
+
+    struct SequenceHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t numKeyframes;
+        uint32_t reserved;
+    };
+
+    struct KeyframeHeader
+    {
+        double timeSeconds;
+        uint32_t numChanges;
+        uint32_t reserved;
+    };
+
+    struct PartialChange
+    {
+        uint32_t index;
+        float amplitude;
+    };
+
+    TimbreSequencePlayer() : juce::Thread("TimbreSequence") {}
+
+    ~TimbreSequencePlayer() override
+    {
+        stopThread(1000);
+    }
+
+    // Message thread. Stops any running playback, maps the file and primes
+    // the ring with the first keyframes. Call again to rewind.
+    bool open(const juce::File& file)
+    {
+        stopPlayback();
+        stopThread(1000);
+        armed.store(false, std::memory_order_release);
+
+        mapping = nullptr;
+        data = nullptr;
+        dataSize = 0;
+
+        if (!file.existsAsFile())
+            return false;
+
+        mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+
+        if (mapping->getData() == nullptr || mapping->getSize() < sizeof(SequenceHeader))
+        {
+            mapping = nullptr;
+            return false;
+        }
+
+        SequenceHeader header;
+        std::memcpy(&header, mapping->getData(), sizeof(header));
+        if (header.magic != SEQUENCE_MAGIC || header.version != SEQUENCE_VERSION)
+        {
+            mapping = nullptr;
+            return false;
+        }
+
+        data = static_cast<const char*>(mapping->getData());
+        dataSize = mapping->getSize();
+        decodeOffset = sizeof(SequenceHeader);
+        cumulative.fill(0.0f);
+
+        // The audio-side state (playhead, current/next frames, ring read
+        // position) is never touched from here: an in-flight evaluateBlock
+        // may already be past the playing check. Bumping the session counter
+        // makes the audio thread reset itself and discard any ring frames
+        // decoded for the previous file.
+        sessionCounter.fetch_add(1, std::memory_order_release);
+
+        startThread();
+        armed.store(true, std::memory_order_release);
+        return true;
+    }
+
+    void startPlayback()
+    {
+        if (armed.load(std::memory_order_acquire))
+            playing.store(true, std::memory_order_release);
+    }
+
+    void stopPlayback() { playing.store(false, std::memory_order_release); }
+    bool isPlaying() const { return playing.load(std::memory_order_relaxed); }
+
+    void prepare(double sampleRate) { currentSampleRate = sampleRate; }
+
+    // Audio thread, once per block. Returns the 128 interpolated amplitudes
+    // for this block, or nullptr when stopped or unchanged — the same
+    // contract as the morph evaluators, so the caller can chain them.
+    const float* evaluateBlock(int numSamples)
+    {
+        if (!playing.load(std::memory_order_acquire))
+            return nullptr;
+
+        // A new open() since the last block: rewind here, on the audio
+        // thread, where no evaluate can be in flight against the old state.
+        uint64_t s = sessionCounter.load(std::memory_order_acquire);
+        if (s != activeSession)
+        {
+            activeSession = s;
+            haveCurrent = false;
+            haveNext = false;
+            holdReturned = false;
+            playheadSamples = 0;
+        }
+
+        if (!haveCurrent)
+        {
+            if (!popKeyframe(current)) // decoder not primed yet — try next block
+                return nullptr;
+
+            haveCurrent = true;
+            haveNext = popKeyframe(next);
+            notify();
+        }
+
+        double t = static_cast<double>(playheadSamples) / currentSampleRate;
+        playheadSamples += numSamples;
+
+        // A dropout may have left us without a lookahead frame mid-stream;
+        // keep asking until the decoder catches up or the file really ends.
+        if (!haveNext)
+        {
+            haveNext = popKeyframe(next);
+            if (haveNext)
+            {
+                notify();
+                holdReturned = false;
+            }
+        }
+
+        while (haveNext && t >= next.timeSeconds)
+        {
+            current = next;
+            haveNext = popKeyframe(next);
+            notify();
+            holdReturned = false;
+        }
+
+        if (!haveNext)
+        {
+            // Past the last keyframe: report it once so the ramps settle
+            // there, then go quiet like the other evaluators.
+            if (holdReturned)
+                return nullptr;
+
+            holdReturned = true;
+            return current.amplitudes.data();
+        }
+
+        double span = next.timeSeconds - current.timeSeconds;
+        float alpha = span > 0.0
+            ? static_cast<float>(juce::jlimit(0.0, 1.0, (t - current.timeSeconds) / span))
+            : 1.0f;
+
+        for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+            interpolated[i] = current.amplitudes[i]
+                            + alpha * (next.amplitudes[i] - current.amplitudes[i]);
+
+        return interpolated.data();
+    }
+
+    // Offline utility for building a sequence from full (time, amplitudes)
+    // snapshots; consecutive snapshots are delta-encoded against each other.
+    static bool writeSequence(const juce::File& file,
+                              const std::vector<std::pair<double, std::array<float, Constants::MAX_HARMONICS>>>& keyframes)
+    {
+        juce::MemoryBlock blob;
+
+        SequenceHeader header { SEQUENCE_MAGIC, SEQUENCE_VERSION,
+                                static_cast<uint32_t>(keyframes.size()), 0 };
+        blob.append(&header, sizeof(header));
+
+        std::array<float, Constants::MAX_HARMONICS> previous {};
+        std::vector<PartialChange> changes;
+        changes.reserve(Constants::MAX_HARMONICS);
+
+        for (const auto& keyframe : keyframes)
+        {
+            changes.clear();
+            for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+                if (keyframe.second[i] != previous[i])
+                    changes.push_back({ static_cast<uint32_t>(i), keyframe.second[i] });
+
+            KeyframeHeader keyframeHeader { keyframe.first, static_cast<uint32_t>(changes.size()), 0 };
+            blob.append(&keyframeHeader, sizeof(keyframeHeader));
+            if (!changes.empty())
+                blob.append(changes.data(), changes.size() * sizeof(PartialChange));
+
+            previous = keyframe.second;
+        }
+
+        return file.replaceWithData(blob.getData(), blob.getSize());
+    }
+
+private:
+    struct Keyframe
+    {
+        double timeSeconds = 0.0;
+        uint64_t session = 0; // which open() decoded this frame
+        std::array<float, Constants::MAX_HARMONICS> amplitudes {};
+    };
+
+    static constexpr int RING_SIZE = 8;
+    static constexpr int RING_MASK = RING_SIZE - 1;
+
+    // Decoder thread: applies each keyframe's deltas to the running
+    // cumulative state and pushes full snapshots until the ring is full,
+    // then sleeps until the audio thread consumes a frame.
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            while (!threadShouldExit() && decodeOffset < dataSize && ringHasSpace())
+                if (!decodeNextKeyframe())
+                    break;
+
+            wait(-1);
+        }
+    }
+
+    bool decodeNextKeyframe()
+    {
+        if (decodeOffset + sizeof(KeyframeHeader) > dataSize)
+        {
+            decodeOffset = dataSize; // truncated file — treat as end of stream
+            return false;
+        }
+
+        KeyframeHeader keyframeHeader;
+        std::memcpy(&keyframeHeader, data + decodeOffset, sizeof(keyframeHeader));
+
+        size_t changesBytes = keyframeHeader.numChanges * sizeof(PartialChange);
+        if (decodeOffset + sizeof(keyframeHeader) + changesBytes > dataSize)
+        {
+            decodeOffset = dataSize;
+            return false;
+        }
+        decodeOffset += sizeof(keyframeHeader);
+
+        for (uint32_t c = 0; c < keyframeHeader.numChanges; ++c)
+        {
+            PartialChange change;
+            std::memcpy(&change, data + decodeOffset + c * sizeof(PartialChange), sizeof(change));
+            if (change.index < static_cast<uint32_t>(Constants::MAX_HARMONICS))
+                cumulative[change.index] = change.amplitude;
+        }
+        decodeOffset += changesBytes;
+
+        int w = ringWrite.load(std::memory_order_relaxed);
+        ring[w & RING_MASK].timeSeconds = keyframeHeader.timeSeconds;
+        ring[w & RING_MASK].session = sessionCounter.load(std::memory_order_relaxed);
+        ring[w & RING_MASK].amplitudes = cumulative;
+        ringWrite.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool ringHasSpace() const
+    {
+        return ringWrite.load(std::memory_order_relaxed)
+             - ringRead.load(std::memory_order_acquire) < RING_SIZE;
+    }
+
+    // Audio thread only. Frames decoded for a previous open() are drained
+    // and discarded — the ring indices themselves are never reset, so the
+    // SPSC discipline holds across reopens.
+    bool popKeyframe(Keyframe& out)
+    {
+        for (;;)
+        {
+            int r = ringRead.load(std::memory_order_relaxed);
+            if (r == ringWrite.load(std::memory_order_acquire))
+                return false;
+
+            out = ring[r & RING_MASK];
+            ringRead.store(r + 1, std::memory_order_release);
+
+            if (out.session == activeSession)
+                return true;
+
+            notify(); // freed a slot the decoder may be waiting on
+        }
+    }
+
+    std::unique_ptr<juce::MemoryMappedFile> mapping;
+    const char* data = nullptr;
+    size_t dataSize = 0;
+
+    // Decoder-side state
+    size_t decodeOffset = 0;
+    std::array<float, Constants::MAX_HARMONICS> cumulative {};
+
+    std::array<Keyframe, RING_SIZE> ring;
+    std::atomic<int> ringWrite { 0 };
+    std::atomic<int> ringRead { 0 };
+
+    std::atomic<bool> armed { false };
+    std::atomic<bool> playing { false };
+    std::atomic<uint64_t> sessionCounter { 0 }; // bumped by every open()
+
+    // Audio-side state
+    Keyframe current, next;
+    uint64_t activeSession = 0;
+    bool haveCurrent = false;
+    bool haveNext = false;
+    bool holdReturned = false;
+    int64_t playheadSamples = 0;
+    double currentSampleRate = 44100.0;
+    std::array<float, Constants::MAX_HARMONICS> interpolated {};
+};
+
+//==============================================================================
+// STATE EXCHANGE
+//
+// Wait-free UI -> audio handoff using the classic triple buffer: one slot is
+// owned by the writer, one by the reader, and one is in flight, with a dirty
+// bit packed into the atomic so neither side ever blocks or tears a state
+// mid-block. The audio thread adopts new states only at block boundaries.
+//==============================================================================
+template <typename StateType>
+class StateExchange
+{
+public:
+    // UI thread: copy into the writer's slot, then publish with one atomic swap.
+    void publish(const StateType& state)
+    {
+        buffers[writeSlot] = state;
+        int previous = pending.exchange(writeSlot | dirtyBit, std::memory_order_acq_rel);
+        writeSlot = previous & indexMask;
+    }
+
+    // Audio thread: returns the freshly published state once, otherwise
+    // nullptr. The returned slot stays valid until the next fetch.
+    const StateType* fetchLatest()
+    {
+        if ((pending.load(std::memory_order_relaxed) & dirtyBit) == 0)
+            return nullptr;
+
+        int previous = pending.exchange(readSlot, std::memory_order_acq_rel);
+        readSlot = previous & indexMask;
+        return &buffers[readSlot];
+    }
+
+private:
+    static constexpr int dirtyBit = 4;
+    static constexpr int indexMask = 3;
+
+    std::array<StateType, 3> buffers;
+    int writeSlot = 0;
+    int readSlot = 2;
+    std::atomic<int> pending { 1 };
+};
+
+using HarmonicStateExchange = StateExchange<HarmonicState>;
+
+//==============================================================================
+// MORPHING ENGINE
+//
+// Morphing runs on the audio path: per-partial deltas (target - source) are
+// precomputed when an endpoint is set and published through the lock-free
+// exchange, and the audio thread evaluates source + amount * delta once per
+// block. Host automation of the morph amount is a single atomic store — no
+// state copies on either thread.
+//==============================================================================
+class MorphingEngine
+{
+public:
+    void setSourceState(const HarmonicState& source) { sourceState.copyFrom(source); publishEndpoints(); }
+    void setTargetState(const HarmonicState& target) { targetState.copyFrom(target); publishEndpoints(); }
+
+    void setMorphAmount(float amount)
+    {
+        morphAmount.store(juce::jlimit(0.0f, 1.0f, amount), std::memory_order_relaxed);
+    }
+
+    float getMorphAmount() const { return morphAmount.load(std::memory_order_relaxed); }
+
+    // UI-side convenience for display purposes only.
+    HarmonicState getCurrentState() const
+    {
+        HarmonicState result;
+        result.copyFrom(sourceState);
+        result.morphTo(targetState, getMorphAmount());
+        return result;
+    }
+
+    // Audio thread, once per block. Returns the 128 morphed target
+    // amplitudes when they changed since the last call, otherwise nullptr.
+    const float* evaluateBlock()
+    {
+        const auto* fresh = endpointExchange.fetchLatest();
+        if (fresh != nullptr)
+            activeEndpoints = fresh;
+
+        if (activeEndpoints == nullptr)
+            return nullptr;
+
+        float amount = morphAmount.load(std::memory_order_relaxed);
+        if (fresh == nullptr && amount == lastEvaluatedAmount)
+            return nullptr;
+
+        lastEvaluatedAmount = amount;
+        for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+            morphed[i] = activeEndpoints->source[i] + amount * activeEndpoints->delta[i];
+
+        return morphed.data();
+    }
+
+private:
+    struct MorphEndpoints
+    {
+        std::array<float, Constants::MAX_HARMONICS> source {};
+        std::array<float, Constants::MAX_HARMONICS> delta {};
+    };
+
+    void publishEndpoints()
+    {
+        MorphEndpoints endpoints;
+        for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+        {
+            endpoints.source[i] = sourceState.getHarmonicAmplitude(i);
+            endpoints.delta[i] = targetState.getHarmonicAmplitude(i) - endpoints.source[i];
+        }
+        endpointExchange.publish(endpoints);
+    }
+
+    HarmonicState sourceState, targetState; // UI-side copies
+    StateExchange<MorphEndpoints> endpointExchange;
+
+    // Audio-side state
+    const MorphEndpoints* activeEndpoints = nullptr;
+    std::array<float, Constants::MAX_HARMONICS> morphed {};
+    float lastEvaluatedAmount = -1.0f;
+
+    std::atomic<float> morphAmount { 0.0f };
+};
+
+//==============================================================================
+// MORPH MAP
+//
+// N-point morphing: up to 16 HarmonicState snapshots placed on a normalized
+// 2-D surface. A coarse grid precomputed on the UI thread stores the k
+// nearest snapshots per cell, so evaluating a morph position on the audio
+// thread touches only those candidates — inverse-square-distance weighted,
+// allocation-free, and cheap enough for block-rate XY-pad control. The map
+// is published through the same lock-free exchange as the other UI state,
+// and the position is one packed atomic store.
+//==============================================================================
+class MorphMap
+{
+public:
+    static constexpr int MAX_POINTS = 16;
+    static constexpr int K_NEIGHBOURS = 4;
+    static constexpr int GRID_RESOLUTION = 16;
+
+    // UI thread. Coordinates are normalized to [0, 1].
+    void setPoint(int index, float x, float y, const HarmonicState& state)
+    {
+        if (index < 0 || index >= MAX_POINTS)
+            return;
+
+        points[index].x = juce::jlimit(0.0f, 1.0f, x);
+        points[index].y = juce::jlimit(0.0f, 1.0f, y);
+        for (int i = 0; i < Constants::MAX_HARMONICS; ++i)
+            points[index].amplitudes[i] = state.getHarmonicAmplitude(i);
+        points[index].used = true;
+
+        rebuildAndPublish();
+    }
+
+    void removePoint(int index)
+    {
+        if (index >= 0 && index < MAX_POINTS && points[index].used)
+        {
+            points[index].used = false;
+            rebuildAndPublish();
+        }
     }
-    
-    void stopNote(float, bool allowTailOff) override
+
+    // Any thread; typically automated. One atomic store.
+    void setPosition(float x, float y)
     {
-        if (allowTailOff)
-            envelope.noteOff();
-        else
-            clearCurrentNote();
+        uint32_t xBits, yBits;
+        x = juce::jlimit(0.0f, 1.0f, x);
+        y = juce::jlimit(0.0f, 1.0f, y);
+        std::memcpy(&xBits, &x, sizeof(float));
+        std::memcpy(&yBits, &y, sizeof(float));
+        position.store((static_cast<uint64_t>(xBits) << 32) | yBits, std::memory_order_relaxed);
     }
-    
-    void pitchWheelMoved(int) override {}
-    void controllerMoved(int, int) override {}
-    
-    void renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
-                        int startSample, int numSamples) override
+
+    // Audio thread, once per block. Returns 128 interpolated amplitudes when
+    // the position or the map changed since the last call, otherwise nullptr.
+    const float* evaluateBlock()
     {
-        if (!envelope.isActive())
+        const auto* fresh = mapExchange.fetchLatest();
+        if (fresh != nullptr)
+            activeMap = fresh;
+
+        if (activeMap == nullptr || activeMap->numPoints == 0)
+            return nullptr;
+
+        uint64_t pos = position.load(std::memory_order_relaxed);
+        if (fresh == nullptr && pos == lastEvaluatedPosition)
+            return nullptr;
+        lastEvaluatedPosition = pos;
+
+        float x, y;
+        uint32_t xBits = static_cast<uint32_t>(pos >> 32), yBits = static_cast<uint32_t>(pos);
+        std::memcpy(&x, &xBits, sizeof(float));
+        std::memcpy(&y, &yBits, sizeof(float));
+
+        int cell = cellIndex(x, y);
+        int count = activeMap->neighbourCounts[cell];
+
+        float weights[K_NEIGHBOURS];
+        float totalWeight = 0.0f;
+
+        for (int c = 0; c < count; ++c)
         {
-            clearCurrentNote();
-            return;
+            int p = activeMap->neighbours[cell][c];
+            float dx = x - activeMap->xs[p], dy = y - activeMap->ys[p];
+            float distSquared = dx * dx + dy * dy;
+
+            if (distSquared < 1.0e-6f) // on top of a snapshot — use it verbatim
+            {
+                juce::FloatVectorOperations::copy(morphed.data(), activeMap->amplitudes[p].data(),
+                                                  Constants::MAX_HARMONICS);
+                return morphed.data();
+            }
+
+            weights[c] = 1.0f / distSquared;
+            totalWeight += weights[c];
         }
-        
-        for (int i = 0; i < numSamples; ++i)
+
+        juce::FloatVectorOperations::clear(morphed.data(), Constants::MAX_HARMONICS);
+        for (int c = 0; c < count; ++c)
         {
-            float envLevel = envelope.getNextSample();
-            float sample = oscillator.getNextSample() * envLevel * currentVelocity;
-            
-            for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch)
-                outputBuffer.addSample(ch, startSample + i, sample);
+            int p = activeMap->neighbours[cell][c];
+            juce::FloatVectorOperations::addWithMultiply(morphed.data(), activeMap->amplitudes[p].data(),
+                                                         weights[c] / totalWeight, Constants::MAX_HARMONICS);
         }
+
+        return morphed.data();
     }
-    
-    void prepare(double sampleRate)
+
+private:
+    struct MapData
     {
-        oscillator.prepare(sampleRate);
-        envelope.prepare(sampleRate);
-    }
-    
-    void setHarmonicState(const HarmonicState& state)
+        int numPoints = 0;
+        std::array<float, MAX_POINTS> xs {}, ys {};
+        std::array<std::array<float, Constants::MAX_HARMONICS>, MAX_POINTS> amplitudes {};
+        std::array<std::array<uint8_t, K_NEIGHBOURS>, GRID_RESOLUTION * GRID_RESOLUTION> neighbours {};
+        std::array<uint8_t, GRID_RESOLUTION * GRID_RESOLUTION> neighbourCounts {};
+    };
+
+    struct Point
+    {
+        float x = 0.0f, y = 0.0f;
+        std::array<float, Constants::MAX_HARMONICS> amplitudes {};
+        bool used = false;
+    };
+
+    static int cellIndex(float x, float y)
     {
-        oscillator.setHarmonicState(state);
+        int cx = juce::jlimit(0, GRID_RESOLUTION - 1, static_cast<int>(x * GRID_RESOLUTION));
+        int cy = juce::jlimit(0, GRID_RESOLUTION - 1, static_cast<int>(y * GRID_RESOLUTION));
+        return cy * GRID_RESOLUTION + cx;
     }
-    
-    void setEnvelope(float attack, float decay, float sustain, float release)
+
+    void rebuildAndPublish()
     {
-        envelope.setAttack(attack);
-        envelope.setDecay(decay);
-        envelope.setSustain(sustain);
-        envelope.setRelease(release);
+        MapData data;
+
+        for (const auto& point : points)
+        {
+            if (!point.used)
+                continue;
+
+            int p = data.numPoints++;
+            data.xs[p] = point.x;
+            data.ys[p] = point.y;
+            data.amplitudes[p] = point.amplitudes;
+        }
+
+        // Precompute the k nearest snapshots for every grid cell centre.
+        for (int cy = 0; cy < GRID_RESOLUTION; ++cy)
+        {
+            for (int cx = 0; cx < GRID_RESOLUTION; ++cx)
+            {
+                float centreX = (cx + 0.5f) / GRID_RESOLUTION;
+                float centreY = (cy + 0.5f) / GRID_RESOLUTION;
+                int cell = cy * GRID_RESOLUTION + cx;
+
+                int count = juce::jmin(K_NEIGHBOURS, data.numPoints);
+                data.neighbourCounts[cell] = static_cast<uint8_t>(count);
+
+                // Selection of the k smallest distances — n is at most 16.
+                std::array<int, MAX_POINTS> order {};
+                for (int p = 0; p < data.numPoints; ++p)
+                    order[p] = p;
+
+                auto distanceTo = [&](int p)
+                {
+                    float dx = centreX - data.xs[p], dy = centreY - data.ys[p];
+                    return dx * dx + dy * dy;
+                };
+
+                std::partial_sort(order.begin(), order.begin() + count, order.begin() + data.numPoints,
+                                  [&](int a, int b) { return distanceTo(a) < distanceTo(b); });
+
+                for (int c = 0; c < count; ++c)
+                    data.neighbours[cell][c] = static_cast<uint8_t>(order[c]);
+            }
+        }
+
+        mapExchange.publish(data);
     }
-    
-private:
-    HarmonicOscillator oscillator;
-    EnvelopeProcessor envelope;
-    float currentVelocity = 1.0f;
-};
 
-//==============================================================================
-// ADDITIVE SOUND
-//==============================================================================
-class AdditiveSound : public juce::SynthesiserSound
-{
-public:
-    bool appliesToNote(int) override { return true; }
-    bool appliesToChannel(int) override { return true; }
+    std::array<Point, MAX_POINTS> points;
+    StateExchange<MapData> mapExchange;
+
+    // Audio-side state
+    const MapData* activeMap = nullptr;
+    std::array<float, Constants::MAX_HARMONICS> morphed {};
+    uint64_t lastEvaluatedPosition = ~0ull;
+
+    std::atomic<uint64_t> position { 0 };
 };
 
 //==============================================================================
-// MORPHING ENGINE
+// PROGRAM SWITCHER
+//
+// Double-buffered program switching: the incoming program's full engine
+// state — harmonics plus everything the audio thread would otherwise have
+// to rebuild on adoption (per-partial envelope coefficients, the
+// active-partial ceiling) — is prepared on a background thread into a
+// standby block and published through the lock-free exchange. The audio
+// thread adopts it with plain copies at the next block boundary and the
+// per-partial smoothing ramps render the crossfade from the old program,
+// so a switch lands within one buffer without a click, even mid-chord.
 //==============================================================================
-class MorphingEngine
+class ProgramSwitcher : private juce::Thread
 {
 public:
-    void setSourceState(const HarmonicState& source) { sourceState.copyFrom(source); }
-    void setTargetState(const HarmonicState& target) { targetState.copyFrom(target); }
-    void setMorphAmount(float amount) { morphAmount = juce::jlimit(0.0f, 1.0f, amount); }
-    
-    HarmonicState getCurrentState() const
+    struct PreparedProgram
     {
-        HarmonicState result;
-        result.copyFrom(sourceState);
-        result.morphTo(targetState, morphAmount);
-        return result;
+        HarmonicState state;
+        PartialEnvelopeMatrix::Shape envelopeShape;
+        int highestActivePartial = -1;
+    };
+
+    ProgramSwitcher() : juce::Thread("ProgramSwitch")
+    {
+        startThread();
     }
-    
-    float getMorphAmount() const { return morphAmount; }
-    
+
+    ~ProgramSwitcher() override
+    {
+        stopThread(1000);
+    }
+
+    // Programs requested after this call are prepared for the new rate.
+    void prepare(double sampleRate)
+    {
+        const juce::SpinLock::ScopedLockType lock(pendingLock);
+        currentSampleRate = sampleRate;
+    }
+
+    // Message thread: queue a program for background preparation. A newer
+    // request simply overwrites a pending one — only the latest matters.
+    void requestSwitch(const HarmonicState& state)
+    {
+        {
+            const juce::SpinLock::ScopedLockType lock(pendingLock);
+            pendingState.copyFrom(state);
+            hasPending = true;
+        }
+        notify();
+    }
+
+    // Audio thread, once per block. Returns the freshly prepared program
+    // once, otherwise nullptr; the slot stays valid until the next fetch.
+    const PreparedProgram* fetchPrepared() { return exchange.fetchLatest(); }
+
 private:
-    HarmonicState sourceState, targetState;
-    float morphAmount = 0.0f;
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            double sampleRate = 44100.0;
+            bool work = false;
+
+            {
+                const juce::SpinLock::ScopedLockType lock(pendingLock);
+                if (hasPending)
+                {
+                    workState.copyFrom(pendingState);
+                    hasPending = false;
+                    sampleRate = currentSampleRate;
+                    work = true;
+                }
+            }
+
+            if (!work)
+            {
+                wait(-1);
+                continue;
+            }
+
+            // All the expensive derivation happens here, off the audio
+            // thread: 128 exp() calls for the envelope coefficients plus
+            // the active-list walk.
+            standby.state.copyFrom(workState);
+            standby.envelopeShape.update(workState, sampleRate);
+
+            int numActive = workState.getNumActivePartials();
+            standby.highestActivePartial = numActive > 0
+                ? workState.getActivePartials()[numActive - 1] // frequency-ordered
+                : -1;
+
+            exchange.publish(standby);
+        }
+    }
+
+    juce::SpinLock pendingLock;
+    HarmonicState pendingState;
+    bool hasPending = false;
+    double currentSampleRate = 44100.0;
+
+    HarmonicState workState;   // prep-thread scratch
+    PreparedProgram standby;
+    StateExchange<PreparedProgram> exchange;
 };
 
 //==============================================================================
@@ -505,145 +2562,231 @@ public:
 //==============================================================================
 // HARMONIC EDITOR COMPONENT
 //==============================================================================
-class HarmonicEditor : public juce::Component
+class HarmonicEditor : public juce::Component, private juce::Timer
 {
 public:
     HarmonicEditor()
     {
         setSize(600, 220);
     }
-    
+
     void paint(juce::Graphics& g) override
     {
-        g.fillAll(juce::Colour(0xff1e1e1e));
-        
+        // The static layer (background, grid, labels) is rendered into an
+        // image once per resize; a drag only invalidates the damaged bar
+        // columns, so this blit and the loop below are clipped to them.
+        if (backgroundImage.isNull()
+            || backgroundImage.getWidth() != getWidth()
+            || backgroundImage.getHeight() != getHeight())
+            rebuildBackground();
+
+        g.drawImageAt(backgroundImage, 0, 0);
+
         auto bounds = getLocalBounds().reduced(10);
         bounds.removeFromBottom(20); // Space for labels
-        
-       
-        // Draw grid lines
-        g.setColour(juce::Colours::white.withAlpha(0.1f));
-        for (int i = 1; i <= 4; ++i)
-        {
-            int y = bounds.getY() + bounds.getHeight() * i / 5;
-            g.drawLine(bounds.getX(), y, bounds.getRight(), y);
-        }
-        
-        // Draw harmonic bars
+
         int barWidth = bounds.getWidth() / Constants::VISIBLE_HARMONICS;
-        
+        auto clip = g.getClipBounds();
+
         for (int i = 0; i < Constants::VISIBLE_HARMONICS; ++i)
         {
+            if (!clip.intersects(columnBounds(i)))
+                continue;
+
             float amp = currentState.getHarmonicAmplitude(i);
             int barHeight = static_cast<int>(amp * bounds.getHeight());
-            
+
             int x = bounds.getX() + i * barWidth + 1;
             int y = bounds.getBottom() - barHeight;
-            
-            juce::Colour barColour = (i == selectedHarmonic) 
-                ? juce::Colour(0xffff6b4a) 
+
+            juce::Colour barColour = (i == selectedHarmonic)
+                ? juce::Colour(0xffff6b4a)
                 : juce::Colour(0xff4a9eff);
-            
+
             if (amp > 0.001f)
             {
                 g.setColour(barColour);
                 g.fillRect(x, y, barWidth - 2, barHeight);
-                
+
                 // Glow effect
                 g.setColour(barColour.withAlpha(0.3f));
                 g.drawRect(x - 1, y - 1, barWidth, barHeight + 2);
             }
         }
-        
-        // Draw frequency labels
-        g.setColour(juce::Colours::grey);
-        g.setFont(9.0f);
-        auto labelBounds = getLocalBounds().removeFromBottom(15);
-        g.drawText("1", labelBounds.removeFromLeft(barWidth * 1), juce::Justification::left, false);
-        g.drawText("8", labelBounds.removeFromLeft(barWidth * 7), juce::Justification::left, false);
-        g.drawText("16", labelBounds.removeFromLeft(barWidth * 8), juce::Justification::left, false);
-        g.drawText("32", labelBounds, juce::Justification::left, false);
     }
-    
+
     void mouseDown(const juce::MouseEvent& e) override
     {
         isDragging = true;
         updateHarmonicFromMouse(e.position);
     }
-    
+
     void mouseDrag(const juce::MouseEvent& e) override
     {
         if (isDragging)
             updateHarmonicFromMouse(e.position);
     }
-    
+
     void mouseUp(const juce::MouseEvent&) override
     {
         isDragging = false;
     }
-    
+
     void setHarmonicState(const HarmonicState& state)
     {
+        if (state.getGeneration() == currentState.getGeneration())
+            return; // identical state — nothing to redraw
+
         currentState.copyFrom(state);
         repaint();
     }
-    
+
     const HarmonicState& getHarmonicState() const { return currentState; }
-    
-    std::function<void(const HarmonicState&)> onStateChanged;
-    
+
+    // Fired from a ~60 Hz coalescing timer rather than per mouse-move; the
+    // second argument lists only the harmonics edited since the last tick.
+    std::function<void(const HarmonicState&, const std::vector<int>&)> onStateChanged;
+
 private:
     HarmonicState currentState;
+    juce::Image backgroundImage;
+    std::array<bool, Constants::VISIBLE_HARMONICS> changedSinceNotify {};
+    std::vector<int> changedIndices;
     int selectedHarmonic = -1;
     bool isDragging = false;
-    
+
+    void rebuildBackground()
+    {
+        backgroundImage = juce::Image(juce::Image::ARGB, getWidth(), getHeight(), true);
+        juce::Graphics g(backgroundImage);
+
+        g.fillAll(juce::Colour(0xff1e1e1e));
+
+        auto bounds = getLocalBounds().reduced(10);
+        bounds.removeFromBottom(20); // Space for labels
+
+        // Draw grid lines
+        g.setColour(juce::Colours::white.withAlpha(0.1f));
+        for (int i = 1; i <= 4; ++i)
+        {
+            int y = bounds.getY() + bounds.getHeight() * i / 5;
+            g.drawLine(bounds.getX(), y, bounds.getRight(), y);
+        }
+
+        // Draw frequency labels
+        int barWidth = bounds.getWidth() / Constants::VISIBLE_HARMONICS;
+        g.setColour(juce::Colours::grey);
+        g.setFont(9.0f);
+        auto labelBounds = getLocalBounds().removeFromBottom(15);
+        g.drawText("1", labelBounds.removeFromLeft(barWidth * 1), juce::Justification::left, false);
+        g.drawText("8", labelBounds.removeFromLeft(barWidth * 7), juce::Justification::left, false);
+        g.drawText("16", labelBounds.removeFromLeft(barWidth * 8), juce::Justification::left, false);
+        g.drawText("32", labelBounds, juce::Justification::left, false);
+    }
+
+    // Full-height column rect for one bar, widened by a pixel each side so
+    // the glow outline is covered too.
+    juce::Rectangle<int> columnBounds(int harmonic) const
+    {
+        auto bounds = getLocalBounds().reduced(10);
+        bounds.removeFromBottom(20);
+
+        int barWidth = bounds.getWidth() / Constants::VISIBLE_HARMONICS;
+        return { bounds.getX() + harmonic * barWidth - 1, bounds.getY() - 1,
+                 barWidth + 2, bounds.getHeight() + 2 };
+    }
+
     void updateHarmonicFromMouse(juce::Point<float> pos)
     {
         auto bounds = getLocalBounds().reduced(10);
         bounds.removeFromBottom(20);
-        
+
         int barWidth = bounds.getWidth() / Constants::VISIBLE_HARMONICS;
         int harmonic = static_cast<int>((pos.x - bounds.getX()) / barWidth);
-        
+
         if (harmonic >= 0 && harmonic < Constants::VISIBLE_HARMONICS)
         {
-            selectedHarmonic = harmonic;
-            float amplitude = juce::jlimit(0.0f, 1.0f, 
+            float amplitude = juce::jlimit(0.0f, 1.0f,
                 (bounds.getBottom() - pos.y) / bounds.getHeight());
-            
+
+            if (harmonic == selectedHarmonic
+                && amplitude == currentState.getHarmonicAmplitude(harmonic))
+                return;
+
+            // Only the damaged columns get repainted: the edited bar, plus
+            // the previous selection when the highlight moves off it.
+            if (selectedHarmonic != harmonic && selectedHarmonic >= 0)
+                repaint(columnBounds(selectedHarmonic));
+            selectedHarmonic = harmonic;
+
             currentState.setHarmonicAmplitude(harmonic, amplitude);
-            
-            if (onStateChanged)
-                onStateChanged(currentState);
-            
-            repaint();
+            repaint(columnBounds(harmonic));
+
+            changedSinceNotify[static_cast<size_t>(harmonic)] = true;
+            if (!isTimerRunning())
+                startTimerHz(60);
         }
     }
+
+    void timerCallback() override
+    {
+        changedIndices.clear();
+        for (int i = 0; i < Constants::VISIBLE_HARMONICS; ++i)
+        {
+            if (changedSinceNotify[static_cast<size_t>(i)])
+            {
+                changedSinceNotify[static_cast<size_t>(i)] = false;
+                changedIndices.push_back(i);
+            }
+        }
+
+        if (changedIndices.empty())
+        {
+            stopTimer();
+            return;
+        }
+
+        if (onStateChanged)
+            onStateChanged(currentState, changedIndices);
+    }
 };
 
 //==============================================================================
 // WAVEFORM VISUALIZER
+//
+// The preview is incremental: each harmonic's sampled waveform never changes,
+// so the rows are computed once and an amplitude edit is just a weighted
+// re-sum of cached rows — no transcendentals. The re-sum runs on a background
+// thread keyed by a generation counter, and the timer only rebuilds the path
+// and repaints when a newer generation has been computed. Idle cost is zero.
 //==============================================================================
-class WaveformVisualizer : public juce::Component, private juce::Timer
+class WaveformVisualizer : public juce::Component, private juce::Timer, private juce::Thread
 {
 public:
-    WaveformVisualizer()
+    WaveformVisualizer() : juce::Thread("WaveformPreview")
     {
         setSize(600, 120);
+        buildHarmonicRows();
+        startThread();
         startTimerHz(30);
     }
-    
+
+    ~WaveformVisualizer() override
+    {
+        stopThread(1000);
+    }
+
     void paint(juce::Graphics& g) override
     {
         g.fillAll(juce::Colour(0xff1a1a1a));
-        
+
         auto bounds = getLocalBounds().reduced(10).toFloat();
-        
+
         // Draw centerline
         g.setColour(juce::Colours::white.withAlpha(0.1f));
-        g.drawLine(bounds.getX(), bounds.getCentreY(), 
+        g.drawLine(bounds.getX(), bounds.getCentreY(),
                    bounds.getRight(), bounds.getCentreY());
-        
+
         // Draw waveform
         if (waveformPath.getLength() > 0)
         {
@@ -651,62 +2794,182 @@ public:
             g.strokePath(waveformPath, juce::PathStrokeType(2.0f));
         }
     }
-    
-    void updateWaveform(const HarmonicState& state)
+
+    void updateWaveform(const HarmonicState& state)
+    {
+        // Generation key: re-pushing an unchanged state queues no work.
+        if (state.getGeneration() == lastQueuedGeneration)
+            return;
+        lastQueuedGeneration = state.getGeneration();
+
+        {
+            const juce::SpinLock::ScopedLockType lock(pendingLock);
+            for (int h = 0; h < PREVIEW_HARMONICS; ++h)
+                pendingAmplitudes[h] = state.getHarmonicAmplitude(h);
+            ++pendingGeneration;
+        }
+        notify();
+    }
+
+private:
+    static constexpr int PREVIEW_SAMPLES = 400;
+    static constexpr int PREVIEW_HARMONICS = 16;
+
+    void buildHarmonicRows()
     {
-        waveformPath.clear();
-        
-        auto bounds = getLocalBounds().reduced(10).toFloat();
-        int numSamples = 400;
         float sampleRate = 44100.0f;
         float frequency = 440.0f;
-        
-        for (int i = 0; i < numSamples; ++i)
+
+        for (int h = 0; h < PREVIEW_HARMONICS; ++h)
+            for (int i = 0; i < PREVIEW_SAMPLES; ++i)
+                harmonicRows[h][i] = std::sin(Constants::TWO_PI * frequency * (h + 1) * i / sampleRate);
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
         {
-            float t = i / sampleRate;
-            float sample = 0.0f;
-            
-            // Sum harmonics
-            for (int h = 0; h < 16; ++h)
+            wait(-1);
+
+            while (!threadShouldExit())
             {
-                float amp = state.getHarmonicAmplitude(h);
-                if (amp > 0.001f)
+                int generation;
+                std::array<float, PREVIEW_HARMONICS> amplitudes;
+                {
+                    const juce::SpinLock::ScopedLockType lock(pendingLock);
+                    generation = pendingGeneration;
+                    amplitudes = pendingAmplitudes;
+                }
+
+                if (generation == computedGeneration.load(std::memory_order_relaxed))
+                    break;
+
+                std::array<float, PREVIEW_SAMPLES> samples {};
+                for (int h = 0; h < PREVIEW_HARMONICS; ++h)
+                {
+                    if (amplitudes[h] > 0.001f)
+                        for (int i = 0; i < PREVIEW_SAMPLES; ++i)
+                            samples[i] += amplitudes[h] * harmonicRows[h][i];
+                }
+
                 {
-                    sample += amp * std::sin(Constants::TWO_PI * frequency * (h + 1) * t);
+                    const juce::SpinLock::ScopedLockType lock(resultLock);
+                    computedSamples = samples;
                 }
+                computedGeneration.store(generation, std::memory_order_release);
             }
-            
-            float x = bounds.getX() + (i / (float)numSamples) * bounds.getWidth();
-            float y = bounds.getCentreY() - sample * bounds.getHeight() * 0.4f;
-            
+        }
+    }
+
+    void timerCallback() override
+    {
+        int computed = computedGeneration.load(std::memory_order_acquire);
+        if (computed == displayedGeneration)
+            return;
+        displayedGeneration = computed;
+
+        std::array<float, PREVIEW_SAMPLES> samples;
+        {
+            const juce::SpinLock::ScopedLockType lock(resultLock);
+            samples = computedSamples;
+        }
+
+        waveformPath.clear();
+        auto bounds = getLocalBounds().reduced(10).toFloat();
+
+        for (int i = 0; i < PREVIEW_SAMPLES; ++i)
+        {
+            float x = bounds.getX() + (i / (float) PREVIEW_SAMPLES) * bounds.getWidth();
+            float y = bounds.getCentreY() - samples[i] * bounds.getHeight() * 0.4f;
+
             if (i == 0)
                 waveformPath.startNewSubPath(x, y);
             else
                 waveformPath.lineTo(x, y);
         }
-        
+
         repaint();
     }
-    
-private:
+
     juce::Path waveformPath;
-    
-    void timerCallback() override
+    std::array<std::array<float, PREVIEW_SAMPLES>, PREVIEW_HARMONICS> harmonicRows {};
+
+    juce::SpinLock pendingLock, resultLock;
+    std::array<float, PREVIEW_HARMONICS> pendingAmplitudes {};
+    std::array<float, PREVIEW_SAMPLES> computedSamples {};
+    int pendingGeneration = 0;
+    std::atomic<int> computedGeneration { 0 };
+    int displayedGeneration = 0;
+    uint64_t lastQueuedGeneration = 0;
+};
+
+//==============================================================================
+// PERFORMANCE MONITOR
+//
+// Lock-free SPSC ring of per-block statistics. The audio thread pays two
+// high-resolution clock reads and one ring store per block; the editor (or
+// host-side telemetry via getPerformanceMonitor) drains at its own rate.
+//==============================================================================
+class PerformanceMonitor
+{
+public:
+    struct BlockStats
+    {
+        float renderTimeMs = 0.0f;
+        float headroom = 1.0f; // fraction of the block deadline left unused
+        int activeVoices = 0;
+        int activePartials = 0;
+        int numSamples = 0;
+    };
+
+    // Audio thread only.
+    void push(const BlockStats& stats)
+    {
+        int w = writeIndex.load(std::memory_order_relaxed);
+        ring[w & RING_MASK] = stats;
+        writeIndex.store(w + 1, std::memory_order_release);
+    }
+
+    // Consumer thread only. Returns false when the ring is empty.
+    bool pop(BlockStats& out)
     {
-        // Animate waveform if needed
+        int r = readIndex.load(std::memory_order_relaxed);
+        if (r == writeIndex.load(std::memory_order_acquire))
+            return false;
+
+        out = ring[r & RING_MASK];
+        readIndex.store(r + 1, std::memory_order_relaxed);
+        return true;
     }
+
+private:
+    static constexpr int RING_SIZE = 256;
+    static constexpr int RING_MASK = RING_SIZE - 1;
+
+    std::array<BlockStats, RING_SIZE> ring;
+    std::atomic<int> writeIndex { 0 };
+    std::atomic<int> readIndex { 0 };
 };
 
 //==============================================================================
 // AUDIO PROCESSOR
 //==============================================================================
-class AdditiveSynthAudioProcessor : public juce::AudioProcessor
+class AdditiveSynthAudioProcessor : public juce::AudioProcessor,
+                                    private juce::Timer
 {
 public:
     AdditiveSynthAudioProcessor()
         : AudioProcessor(BusesProperties()
-                        .withOutput("Output", juce::AudioChannelSet::stereo(), true))
+                        .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+          apvts(*this, nullptr, "PARAMS", createParameterLayout())
     {
+        attackValue = apvts.getRawParameterValue("attack");
+        decayValue = apvts.getRawParameterValue("decay");
+        sustainValue = apvts.getRawParameterValue("sustain");
+        releaseValue = apvts.getRawParameterValue("release");
+        morphValue = apvts.getRawParameterValue("morph");
+        volumeValue = apvts.getRawParameterValue("volume");
+
         synthesiser.clearVoices();
         for (int i = 0; i < Constants::MAX_VOICES; ++i)
             synthesiser.addVoice(new AdditiveVoice());
@@ -716,7 +2979,9 @@ public:
         
         // Initialize with saw wave
         harmonicState.loadPreset("Saw");
-        updateVoicesWithHarmonicState();
+        stateExchange.publish(harmonicState);
+
+        startTimerHz(30); // flushes CC-staged parameter writes to the host
     }
     
     ~AdditiveSynthAudioProcessor() override = default;
@@ -724,22 +2989,110 @@ public:
     void prepareToPlay(double sampleRate, int samplesPerBlock) override
     {
         synthesiser.setCurrentPlaybackSampleRate(sampleRate);
-        
+        currentBlockSize = samplesPerBlock;
+        partialEnvelopeShape.update(harmonicState, sampleRate);
+        synthesiser.setPartialEnvelopeShape(&partialEnvelopeShape);
+        timbreSequence.prepare(sampleRate);
+        programSwitcher.prepare(sampleRate);
+
         for (int i = 0; i < synthesiser.getNumVoices(); ++i)
         {
             if (auto* voice = dynamic_cast<AdditiveVoice*>(synthesiser.getVoice(i)))
             {
-                voice->prepare(sampleRate);
+                voice->prepare(sampleRate, samplesPerBlock);
+                voice->setSharedBank(&sharedPartialBank);
+                voice->setPartialEnvelopeShape(&partialEnvelopeShape);
             }
         }
+
+        // Offline bounce: with no deadline to protect, always spread voices
+        // across every core — farm renders should not leave 31 cores idle.
+        // Realtime keeps the pool opt-in and capped to a few workers.
+        bool offline = isNonRealtime();
+
+        if (multithreadedRendering || offline)
+        {
+            int availableCores = static_cast<int>(std::thread::hardware_concurrency());
+            int numWorkerThreads = offline ? juce::jmax(1, availableCores - 1)
+                                           : juce::jlimit(1, 3, availableCores - 1);
+            renderPool.prepare(getTotalNumOutputChannels(), samplesPerBlock, numWorkerThreads);
+            synthesiser.setRenderPool(&renderPool);
+        }
+        else
+        {
+            synthesiser.setRenderPool(nullptr);
+            renderPool.shutdown();
+        }
+    }
+
+    void releaseResources() override
+    {
+        synthesiser.setRenderPool(nullptr);
+        renderPool.shutdown();
+    }
+
+    // Opt-in: takes effect on the next prepareToPlay.
+    void setMultithreadedRendering(bool shouldUseWorkerPool) { multithreadedRendering = shouldUseWorkerPool; }
+
+    void setSynthesisEngine(HarmonicOscillator::Engine engine)
+    {
+        for (int i = 0; i < synthesiser.getNumVoices(); ++i)
+            if (auto* voice = dynamic_cast<AdditiveVoice*>(synthesiser.getVoice(i)))
+                voice->setSynthesisEngine(engine);
     }
-    
-    void releaseResources() override {}
     
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override
     {
+        auto startTicks = juce::Time::getHighResolutionTicks();
+
+        // Adopt any state the UI published since the last block. The fetch is
+        // wait-free and the walk below only happens when something changed.
+        if (auto* newState = stateExchange.fetchLatest())
+        {
+            applyHarmonicStateToVoices(*newState);
+            currentActivePartials = newState->getNumActivePartials();
+        }
+
+        // Adopt any program the switcher finished preparing: everything
+        // derived arrives precomputed, so the swap is a handful of copies
+        // and the ramps crossfade from the outgoing partials.
+        if (const auto* program = programSwitcher.fetchPrepared())
+        {
+            partialEnvelopeShape = program->envelopeShape;
+            sharedPartialBank.setHarmonicState(program->state);
+            sharedPartialBank.highestActivePartial = program->highestActivePartial;
+            currentActivePartials = program->state.getNumActivePartials();
+        }
+
+        handleControllerBatch(midiMessages);
+
+        // One coherent parameter snapshot per block, taken after the CC batch
+        // so MIDI-mapped parameter writes land in the same block.
+        applyParameterSnapshot();
+
+        // Block-rate morph evaluation: only recomputes when the morph amount
+        // or endpoints changed, and feeds the per-partial smoothing ramps.
+        // A playing timbre sequence drives the targets outright; otherwise
+        // the 2-D morph map, when populated, takes precedence over A/B morph.
+        const float* morphTargets = timbreSequence.evaluateBlock(buffer.getNumSamples());
+        if (morphTargets == nullptr)
+            morphTargets = morphMap.evaluateBlock();
+        if (morphTargets == nullptr)
+            morphTargets = morphingEngine.evaluateBlock();
+
+        if (morphTargets != nullptr)
+        {
+            sharedPartialBank.setTargetAmplitudes(morphTargets);
+            // Morph targets bypass HarmonicState, so the cached ceiling no
+            // longer bounds them.
+            sharedPartialBank.highestActivePartial = Constants::MAX_HARMONICS - 1;
+        }
+
         buffer.clear();
         synthesiser.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+
+        float headroom = pushBlockStats(startTicks, buffer.getNumSamples());
+        governPolyphony(headroom);
     }
     
     juce::AudioProcessorEditor* createEditor() override;
@@ -750,51 +3103,487 @@ public:
     bool producesMidi() const override { return false; }
     double getTailLengthSeconds() const override { return 0.0; }
     
-    int getNumPrograms() override { return 1; }
-    int getCurrentProgram() override { return 0; }
-    void setCurrentProgram(int) override {}
-    const juce::String getProgramName(int) override { return {}; }
+    // The factory presets are exposed as host programs. A switch never
+    // touches the audio thread directly: the incoming program is prepared in
+    // the background and adopted at the next block boundary, with the
+    // smoothing ramps crossfading from the old partials.
+    int getNumPrograms() override { return static_cast<int>(std::size(FACTORY_PROGRAMS)); }
+    int getCurrentProgram() override { return currentProgram; }
+
+    void setCurrentProgram(int index) override
+    {
+        if (index < 0 || index >= getNumPrograms())
+            return;
+
+        currentProgram = index;
+        harmonicState.loadPreset(FACTORY_PROGRAMS[index]);
+        programSwitcher.requestSwitch(harmonicState);
+    }
+
+    const juce::String getProgramName(int index) override
+    {
+        return index >= 0 && index < getNumPrograms() ? FACTORY_PROGRAMS[index] : "";
+    }
+
     void changeProgramName(int, const juce::String&) override {}
+
+    // Glitch-free switch to an arbitrary state (bank presets, editor
+    // shortcuts) through the same background-preparation path.
+    void switchToState(const HarmonicState& state)
+    {
+        harmonicState.copyFrom(state);
+        programSwitcher.requestSwitch(harmonicState);
+    }
     
-    void getStateInformation(juce::MemoryBlock&) override {}
-    void setStateInformation(const void*, int) override {}
+    //==============================================================================
+    // Session state is a versioned fixed-layout binary blob: the harmonic
+    // array memcpys straight in and out of HarmonicState, so restoring 60+
+    // instances on project open costs microseconds each instead of parsing
+    // an XML/ValueTree blob. Bump STATE_VERSION when the layout changes.
+    struct SerializedState
+    {
+        uint32_t magic;
+        uint32_t version;
+        std::array<HarmonicData, Constants::MAX_HARMONICS> harmonics;
+        float attack, decay, sustain, release;
+        float morphAmount;
+    };
+
+    static constexpr uint32_t STATE_MAGIC = 0x41445353; // "ADSS"
+    static constexpr uint32_t STATE_VERSION = 1;
+
+    void getStateInformation(juce::MemoryBlock& destData) override
+    {
+        SerializedState state;
+        state.magic = STATE_MAGIC;
+        state.version = STATE_VERSION;
+        state.harmonics = harmonicState.harmonics;
+        state.attack = attackValue->load(std::memory_order_relaxed);
+        state.decay = decayValue->load(std::memory_order_relaxed);
+        state.sustain = sustainValue->load(std::memory_order_relaxed);
+        state.release = releaseValue->load(std::memory_order_relaxed);
+        state.morphAmount = morphValue->load(std::memory_order_relaxed);
+
+        destData.setSize(sizeof(SerializedState));
+        std::memcpy(destData.getData(), &state, sizeof(SerializedState));
+    }
+
+    void setStateInformation(const void* data, int sizeInBytes) override
+    {
+        if (sizeInBytes < static_cast<int>(sizeof(SerializedState)))
+            return;
+
+        SerializedState state;
+        std::memcpy(&state, data, sizeof(SerializedState));
+
+        if (state.magic != STATE_MAGIC || state.version != STATE_VERSION)
+            return;
+
+        harmonicState.restoreFrom(state.harmonics);
+        stateExchange.publish(harmonicState);
+        setEnvelopeParameters(state.attack, state.decay, state.sustain, state.release);
+        *morphParam = state.morphAmount;
+    }
     
-    // Public interface
+    // Public interface. harmonicState is the UI-side master copy; the audio
+    // thread only ever sees it through the lock-free exchange.
     HarmonicState& getHarmonicState() { return harmonicState; }
     void setHarmonicState(const HarmonicState& state)
     {
         harmonicState.copyFrom(state);
-        updateVoicesWithHarmonicState();
+        stateExchange.publish(harmonicState);
     }
     
+    // Per-partial envelope shape editing goes through the same publish path
+    // as amplitude edits, so the audio thread picks it up lock-free.
+    void setPartialEnvelope(int index, float decaySeconds, float sustain)
+    {
+        harmonicState.setPartialEnvelope(index, decaySeconds, sustain);
+        stateExchange.publish(harmonicState);
+    }
+
+    // Routes through the parameter layer: four atomic writes here, applied to
+    // the voices exactly once by the next block's snapshot.
     void setEnvelopeParameters(float attack, float decay, float sustain, float release)
     {
-        for (int i = 0; i < synthesiser.getNumVoices(); ++i)
-        {
-            if (auto* voice = dynamic_cast<AdditiveVoice*>(synthesiser.getVoice(i)))
-            {
-                voice->setEnvelope(attack, decay, sustain, release);
-            }
-        }
+        *attackParam = attack;
+        *decayParam = decay;
+        *sustainParam = sustain;
+        *releaseParam = release;
     }
-    
+
+    juce::AudioProcessorValueTreeState& getValueTreeState() { return apvts; }
+
+
     MorphingEngine& getMorphingEngine() { return morphingEngine; }
+    MorphMap& getMorphMap() { return morphMap; }
+    PerformanceMonitor& getPerformanceMonitor() { return performanceMonitor; }
+
+    bool openPresetBank(const juce::File& bankFile) { return presetBank.open(bankFile); }
+    PresetBank& getPresetBank() { return presetBank; }
+
+    bool openTimbreSequence(const juce::File& sequenceFile) { return timbreSequence.open(sequenceFile); }
+    TimbreSequencePlayer& getTimbreSequence() { return timbreSequence; }
+
+    bool loadBankPreset(const juce::String& name)
+    {
+        if (!presetBank.loadInto(name.toRawUTF8(), harmonicState))
+            return false;
+
+        programSwitcher.requestSwitch(harmonicState);
+        return true;
+    }
     
 private:
-    juce::Synthesiser synthesiser;
+    // Typed pointers are captured while building the layout (for writes that
+    // must notify the host); the raw atomics are what the per-block snapshot
+    // reads. Declared before apvts so construction order is right.
+    juce::AudioParameterFloat* attackParam = nullptr;
+    juce::AudioParameterFloat* decayParam = nullptr;
+    juce::AudioParameterFloat* sustainParam = nullptr;
+    juce::AudioParameterFloat* releaseParam = nullptr;
+    juce::AudioParameterFloat* morphParam = nullptr;
+    juce::AudioParameterFloat* volumeParam = nullptr;
+    juce::AudioProcessorValueTreeState apvts;
+
+    std::atomic<float>* attackValue = nullptr;
+    std::atomic<float>* decayValue = nullptr;
+    std::atomic<float>* sustainValue = nullptr;
+    std::atomic<float>* releaseValue = nullptr;
+    std::atomic<float>* morphValue = nullptr;
+    std::atomic<float>* volumeValue = nullptr;
+
+    // CC-mapped values staged by the audio thread for the message-thread
+    // timer to write host-visibly; -1 marks the slot empty (every mapped
+    // parameter range is non-negative).
+    std::atomic<float> stagedMorphCC { -1.0f };
+    std::atomic<float> stagedAttackCC { -1.0f };
+    std::atomic<float> stagedDecayCC { -1.0f };
+    std::atomic<float> stagedSustainCC { -1.0f };
+    std::atomic<float> stagedReleaseCC { -1.0f };
+    std::atomic<float> stagedVolumeCC { -1.0f };
+
+    // Values as last applied to the engine; the snapshot only touches voices
+    // when a value actually moved.
+    struct AppliedParameters
+    {
+        float attack = -1.0f, decay = -1.0f, sustain = -1.0f, release = -1.0f;
+        float morph = -1.0f, volume = -1.0f;
+    };
+    AppliedParameters applied;
+
+    AdditiveSynthesiser synthesiser;
+    VoiceRenderPool renderPool;
+    bool multithreadedRendering = false;
     HarmonicState harmonicState;
+    HarmonicStateExchange stateExchange;
     MorphingEngine morphingEngine;
-    
-    void updateVoicesWithHarmonicState()
+    MorphMap morphMap;
+    PerformanceMonitor performanceMonitor;
+    PresetBank presetBank;
+    TimbreSequencePlayer timbreSequence;
+    ProgramSwitcher programSwitcher;
+    static constexpr const char* FACTORY_PROGRAMS[5] = { "Saw", "Square", "Triangle", "Sine", "Organ" };
+    int currentProgram = 0;
+    DerivedStateCache derivedCache;
+    SharedPartialBank sharedPartialBank;
+    PartialEnvelopeMatrix::Shape partialEnvelopeShape;
+    int currentActivePartials = 0;
+    int currentBlockSize = 512;
+
+    // Polyphony governor state
+    static constexpr float SHED_HEADROOM = 0.15f;
+    static constexpr float RECOVER_HEADROOM = 0.45f;
+    static constexpr int SHED_BLOCKS = 4;
+    static constexpr int RECOVER_BLOCKS = 400;
+    static constexpr int MIN_VOICE_CAP = 4;
+
+    int voiceCap = Constants::MAX_VOICES;
+    int overloadStreak = 0;
+    int comfortStreak = 0;
+
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
+    {
+        auto attack = std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID("attack", 1), "Attack",
+            juce::NormalisableRange<float>(0.001f, 2.0f, 0.0f, 0.4f), 0.01f);
+        auto decay = std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID("decay", 1), "Decay",
+            juce::NormalisableRange<float>(0.001f, 2.0f, 0.0f, 0.4f), 0.1f);
+        auto sustain = std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID("sustain", 1), "Sustain",
+            juce::NormalisableRange<float>(0.0f, 1.0f), 0.7f);
+        auto release = std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID("release", 1), "Release",
+            juce::NormalisableRange<float>(0.001f, 5.0f, 0.0f, 0.4f), 0.5f);
+        auto morph = std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID("morph", 1), "Morph A/B",
+            juce::NormalisableRange<float>(0.0f, 1.0f), 0.0f);
+        auto volume = std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID("volume", 1), "Volume",
+            juce::NormalisableRange<float>(0.0f, 1.0f), 0.5f);
+
+        attackParam = attack.get();
+        decayParam = decay.get();
+        sustainParam = sustain.get();
+        releaseParam = release.get();
+        morphParam = morph.get();
+        volumeParam = volume.get();
+
+        juce::AudioProcessorValueTreeState::ParameterLayout layout;
+        layout.add(std::move(attack));
+        layout.add(std::move(decay));
+        layout.add(std::move(sustain));
+        layout.add(std::move(release));
+        layout.add(std::move(morph));
+        layout.add(std::move(volume));
+        return layout;
+    }
+
+    // One coherent snapshot of the parameter atomics per block, applied
+    // exactly once and only where a value actually changed — a host or UI
+    // parameter move is O(1) on both threads instead of a voice walk per
+    // mouse tick.
+    void applyParameterSnapshot()
+    {
+        float attack = attackValue->load(std::memory_order_relaxed);
+        float decay = decayValue->load(std::memory_order_relaxed);
+        float sustain = sustainValue->load(std::memory_order_relaxed);
+        float release = releaseValue->load(std::memory_order_relaxed);
+        float morph = morphValue->load(std::memory_order_relaxed);
+        float volume = volumeValue->load(std::memory_order_relaxed);
+
+        if (attack != applied.attack || decay != applied.decay
+            || sustain != applied.sustain || release != applied.release)
+        {
+            for (int i = 0; i < synthesiser.getNumVoices(); ++i)
+                if (auto* voice = dynamic_cast<AdditiveVoice*>(synthesiser.getVoice(i)))
+                    voice->setEnvelope(attack, decay, sustain, release);
+
+            applied.attack = attack;
+            applied.decay = decay;
+            applied.sustain = sustain;
+            applied.release = release;
+        }
+
+        if (morph != applied.morph)
+        {
+            morphingEngine.setMorphAmount(morph);
+            applied.morph = morph;
+        }
+
+        if (volume != applied.volume)
+        {
+            for (int i = 0; i < synthesiser.getNumVoices(); ++i)
+                if (auto* voice = dynamic_cast<AdditiveVoice*>(synthesiser.getVoice(i)))
+                    voice->setGain(volume);
+
+            applied.volume = volume;
+        }
+    }
+
+    // The CC map advertised in the editor: CC1 morph, CC16-47 harmonics 1-32,
+    // CC73/75/70/72 ADSR, CC7 master volume. All CC events in the block are
+    // coalesced first (last value per controller wins) and applied exactly
+    // once, feeding the per-partial smoothing ramps — a 1 kHz CC stream costs
+    // the same as a single update per block.
+    void handleControllerBatch(const juce::MidiBuffer& midiMessages)
+    {
+        std::array<int, Constants::VISIBLE_HARMONICS> harmonicCC;
+        harmonicCC.fill(-1);
+        int morphCC = -1, attackCC = -1, decayCC = -1, sustainCC = -1, releaseCC = -1, volumeCC = -1;
+        bool anyHarmonic = false;
+
+        for (const auto metadata : midiMessages)
+        {
+            const auto message = metadata.getMessage();
+            if (!message.isController())
+                continue;
+
+            int cc = message.getControllerNumber();
+            int value = message.getControllerValue();
+
+            if (cc >= 16 && cc <= 47)
+            {
+                harmonicCC[cc - 16] = value;
+                anyHarmonic = true;
+            }
+            else if (cc == 1)  morphCC = value;
+            else if (cc == 73) attackCC = value;
+            else if (cc == 75) decayCC = value;
+            else if (cc == 70) sustainCC = value;
+            else if (cc == 72) releaseCC = value;
+            else if (cc == 7)  volumeCC = value;
+        }
+
+        if (anyHarmonic)
+        {
+            for (int h = 0; h < Constants::VISIBLE_HARMONICS; ++h)
+            {
+                if (harmonicCC[h] >= 0)
+                {
+                    sharedPartialBank.setTargetAmplitude(h, harmonicCC[h] / 127.0f);
+
+                    // The ramp scan is clamped to the bank ceiling, so raise
+                    // it when a CC introduces a partial above the patch's
+                    // current highest — otherwise the edit is inaudible.
+                    sharedPartialBank.highestActivePartial =
+                        juce::jmax(sharedPartialBank.highestActivePartial, h);
+                }
+            }
+        }
+
+        // MIDI-mapped parameters land in two steps: the raw-value store is
+        // picked up by this block's snapshot immediately, while the
+        // host-visible parameter write — which runs listeners and may post
+        // messages — is deferred to the message-thread timer. Nothing here
+        // allocates or leaves the audio thread's contract.
+        if (morphCC >= 0)   stageCCParameter(morphValue,   stagedMorphCC,   morphCC / 127.0f);
+        if (attackCC >= 0)  stageCCParameter(attackValue,  stagedAttackCC,  attackCC / 127.0f * 2.0f);
+        if (decayCC >= 0)   stageCCParameter(decayValue,   stagedDecayCC,   decayCC / 127.0f * 2.0f);
+        if (sustainCC >= 0) stageCCParameter(sustainValue, stagedSustainCC, sustainCC / 127.0f);
+        if (releaseCC >= 0) stageCCParameter(releaseValue, stagedReleaseCC, releaseCC / 127.0f * 5.0f);
+        if (volumeCC >= 0)  stageCCParameter(volumeValue,  stagedVolumeCC,  volumeCC / 127.0f);
+    }
+
+    static void stageCCParameter(std::atomic<float>* rawValue, std::atomic<float>& staged, float newValue)
+    {
+        rawValue->store(newValue, std::memory_order_relaxed);
+        staged.store(newValue, std::memory_order_release);
+    }
+
+    static void flushCCParameter(std::atomic<float>& staged, juce::AudioParameterFloat* parameter)
+    {
+        float value = staged.exchange(-1.0f, std::memory_order_acq_rel);
+        if (value >= 0.0f)
+            *parameter = value;
+    }
+
+    // Message thread. Completes the CC-mapped parameter writes so the host
+    // and any attachments see them; the raw values already match, so the
+    // notify is idempotent engine-side.
+    void timerCallback() override
+    {
+        flushCCParameter(stagedMorphCC, morphParam);
+        flushCCParameter(stagedAttackCC, attackParam);
+        flushCCParameter(stagedDecayCC, decayParam);
+        flushCCParameter(stagedSustainCC, sustainParam);
+        flushCCParameter(stagedReleaseCC, releaseParam);
+        flushCCParameter(stagedVolumeCC, volumeParam);
+    }
+
+    float pushBlockStats(int64_t startTicks, int numSamples)
     {
+        auto elapsed = juce::Time::getHighResolutionTicks() - startTicks;
+        float renderMs = 1000.0f * static_cast<float>(elapsed)
+                       / static_cast<float>(juce::Time::getHighResolutionTicksPerSecond());
+        float deadlineMs = 1000.0f * static_cast<float>(numSamples) / static_cast<float>(getSampleRate());
+
+        PerformanceMonitor::BlockStats stats;
+        stats.renderTimeMs = renderMs;
+        stats.headroom = deadlineMs > 0.0f ? 1.0f - renderMs / deadlineMs : 1.0f;
+        stats.activePartials = currentActivePartials;
+        stats.numSamples = numSamples;
+
         for (int i = 0; i < synthesiser.getNumVoices(); ++i)
+            if (synthesiser.getVoice(i)->isVoiceActive())
+                ++stats.activeVoices;
+
+        performanceMonitor.push(stats);
+        return stats.headroom;
+    }
+
+    // Adaptive polyphony governor: the compile-time ceiling is generous
+    // (MAX_VOICES = 64) and the measured per-block headroom finds each
+    // machine's real limit at runtime. Shedding is fast (a few consecutive
+    // tight blocks drop the cap by a quarter) and recovery is slow (seconds
+    // of comfortable headroom raise it one voice at a time), so the cap
+    // cannot flap. Over the cap, the quietest sounding voices are released;
+    // their tails fade through the amplitude ramps and the silence gate
+    // reclaims them within a block or two — graceful degradation, no
+    // dropouts.
+    void governPolyphony(float headroom)
+    {
+        if (headroom < SHED_HEADROOM)
         {
-            if (auto* voice = dynamic_cast<AdditiveVoice*>(synthesiser.getVoice(i)))
+            ++overloadStreak;
+            comfortStreak = 0;
+        }
+        else if (headroom > RECOVER_HEADROOM)
+        {
+            ++comfortStreak;
+            overloadStreak = 0;
+        }
+        else
+        {
+            overloadStreak = 0;
+            comfortStreak = 0;
+        }
+
+        if (overloadStreak >= SHED_BLOCKS && voiceCap > MIN_VOICE_CAP)
+        {
+            voiceCap = juce::jmax(MIN_VOICE_CAP, voiceCap - voiceCap / 4);
+            overloadStreak = 0;
+        }
+        else if (comfortStreak >= RECOVER_BLOCKS && voiceCap < Constants::MAX_VOICES)
+        {
+            ++voiceCap;
+            comfortStreak = 0;
+        }
+
+        enforceVoiceCap();
+    }
+
+    void enforceVoiceCap()
+    {
+        int sounding = 0;
+        for (int i = 0; i < synthesiser.getNumVoices(); ++i)
+        {
+            auto* voice = dynamic_cast<AdditiveVoice*>(synthesiser.getVoice(i));
+            if (voice != nullptr && voice->isVoiceActive() && !voice->isReleasing())
+                ++sounding;
+        }
+
+        // Steal the quietest held voice until we are back under the cap.
+        // Releasing voices are not counted or stolen — they are already on
+        // their way out.
+        while (sounding > voiceCap)
+        {
+            AdditiveVoice* quietest = nullptr;
+            float quietestAudibility = std::numeric_limits<float>::max();
+
+            for (int i = 0; i < synthesiser.getNumVoices(); ++i)
             {
-                voice->setHarmonicState(harmonicState);
+                auto* voice = dynamic_cast<AdditiveVoice*>(synthesiser.getVoice(i));
+                if (voice == nullptr || !voice->isVoiceActive() || voice->isReleasing())
+                    continue;
+
+                float audibility = voice->getAudibility();
+                if (audibility < quietestAudibility)
+                {
+                    quietestAudibility = audibility;
+                    quietest = voice;
+                }
             }
+
+            if (quietest == nullptr)
+                break;
+
+            quietest->stopNote(0.0f, true);
+            --sounding;
         }
     }
+
+    // One write into the shared bank replaces the old copy into all 16
+    // voices; every oscillator reads the bank directly. Derived products come
+    // from the generation-keyed cache, so re-publishing an unchanged state
+    // recomputes nothing.
+    void applyHarmonicStateToVoices(const HarmonicState& state)
+    {
+        partialEnvelopeShape.update(state, getSampleRate());
+        sharedPartialBank.setHarmonicState(state);
+        sharedPartialBank.highestActivePartial = derivedCache.get(state).highestActivePartial;
+    }
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AdditiveSynthAudioProcessor)
 };
@@ -827,15 +3616,16 @@ public:
         
         presetComboBox.onChange = [this]
         {
-            auto preset = presetComboBox.getText();
-            processor.getHarmonicState().loadPreset(preset);
-            processor.setHarmonicState(processor.getHarmonicState());
+            // Routed through the program switcher: the engine state is
+            // prepared in the background and swapped in click-free, so this
+            // handler only pays for the UI refresh.
+            processor.setCurrentProgram(presetComboBox.getSelectedId() - 1);
             harmonicEditor.setHarmonicState(processor.getHarmonicState());
             waveformVisualizer.updateWaveform(processor.getHarmonicState());
         };
         
         // Setup harmonic editor callback
-        harmonicEditor.onStateChanged = [this](const HarmonicState& state)
+        harmonicEditor.onStateChanged = [this](const HarmonicState& state, const std::vector<int>&)
         {
             processor.setHarmonicState(state);
             waveformVisualizer.updateWaveform(state);
@@ -849,10 +3639,9 @@ public:
         
         morphSlider.onValueChange = [this]
         {
-            float amount = morphSlider.getValue();
-            processor.getMorphingEngine().setMorphAmount(amount);
+            // The attachment writes the parameter; these copies are
+            // display-only.
             auto morphedState = processor.getMorphingEngine().getCurrentState();
-            processor.setHarmonicState(morphedState);
             harmonicEditor.setHarmonicState(morphedState);
             waveformVisualizer.updateWaveform(morphedState);
         };
@@ -862,29 +3651,34 @@ public:
         attackSlider.setValue(0.01);
         attackSlider.setSliderStyle(juce::Slider::Rotary);
         attackSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 50, 20);
-        attackSlider.onValueChange = [this] { updateEnvelope(); };
         addAndMakeVisible(attackSlider);
         
         decaySlider.setRange(0.001, 2.0, 0.001);
         decaySlider.setValue(0.1);
         decaySlider.setSliderStyle(juce::Slider::Rotary);
         decaySlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 50, 20);
-        decaySlider.onValueChange = [this] { updateEnvelope(); };
         addAndMakeVisible(decaySlider);
         
         sustainSlider.setRange(0.0, 1.0, 0.01);
         sustainSlider.setValue(0.7);
         sustainSlider.setSliderStyle(juce::Slider::Rotary);
         sustainSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 50, 20);
-        sustainSlider.onValueChange = [this] { updateEnvelope(); };
         addAndMakeVisible(sustainSlider);
         
         releaseSlider.setRange(0.001, 5.0, 0.001);
         releaseSlider.setValue(0.5);
         releaseSlider.setSliderStyle(juce::Slider::Rotary);
         releaseSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 50, 20);
-        releaseSlider.onValueChange = [this] { updateEnvelope(); };
         addAndMakeVisible(releaseSlider);
+
+        // Parameter attachments: slider moves become atomic parameter writes,
+        // applied by the audio thread's per-block snapshot.
+        auto& parameters = processor.getValueTreeState();
+        attackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(parameters, "attack", attackSlider);
+        decayAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(parameters, "decay", decaySlider);
+        sustainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(parameters, "sustain", sustainSlider);
+        releaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(parameters, "release", releaseSlider);
+        morphAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(parameters, "morph", morphSlider);
         
         // Setup labels
         addAndMakeVisible(titleLabel);
@@ -932,6 +3726,11 @@ public:
         addAndMakeVisible(presetLabel);
         presetLabel.setText("Presets:", juce::dontSendNotification);
         presetLabel.setFont(juce::Font (juce::FontOptions(11.0f)));
+
+        addAndMakeVisible(performanceLabel);
+        performanceLabel.setText("CPU --%", juce::dontSendNotification);
+        performanceLabel.setFont(juce::Font (juce::FontOptions(11.0f)));
+        performanceLabel.setColour(juce::Label::textColourId, juce::Colours::lightblue);
         
         // Setup source/target buttons for morphing
         addAndMakeVisible(setSourceButton);
@@ -1069,6 +3868,9 @@ public:
         rightArea.removeFromTop(10);
         
         morphSlider.setBounds(rightArea.removeFromTop(80));
+
+        rightArea.removeFromTop(10);
+        performanceLabel.setBounds(rightArea.removeFromTop(20));
     }
     
 private:
@@ -1082,12 +3884,17 @@ private:
     juce::ComboBox presetComboBox;
     juce::Slider morphSlider;
     juce::Slider attackSlider, decaySlider, sustainSlider, releaseSlider;
-    
+
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>
+        attackAttachment, decayAttachment, sustainAttachment, releaseAttachment, morphAttachment;
+
+
     juce::TextButton setSourceButton, setTargetButton;
     
     juce::Label titleLabel;
     juce::Label harmonicEditorLabel, waveformLabel, morphLabel, envelopeLabel;
     juce::Label presetLabel;
+    juce::Label performanceLabel;
     juce::Label attackLabel, decayLabel, sustainLabel, releaseLabel;
 
     
@@ -1097,22 +3904,36 @@ private:
     // Morphing states
     HarmonicState sourceState, targetState;
     
-    void updateEnvelope()
-    {
-        processor.setEnvelopeParameters(
-            static_cast<float>(attackSlider.getValue()),
-            static_cast<float>(decaySlider.getValue()),
-            static_cast<float>(sustainSlider.getValue()),
-            static_cast<float>(releaseSlider.getValue())
-        );
-    }
-    
     void timerCallback() override
     {
-        // Update visualizations if needed
-        repaint();
+        // Drain the performance ring and show the worst headroom since the
+        // last tick — a momentary overrun must not be averaged away.
+        PerformanceMonitor::BlockStats stats;
+        bool haveStats = false;
+        float worstHeadroom = 1.0f;
+        int activeVoices = 0, activePartials = 0;
+
+        while (processor.getPerformanceMonitor().pop(stats))
+        {
+            haveStats = true;
+            worstHeadroom = juce::jmin(worstHeadroom, stats.headroom);
+            activeVoices = stats.activeVoices;
+            activePartials = stats.activePartials;
+        }
+
+        if (haveStats)
+        {
+            int cpuPercent = juce::jlimit(0, 999, static_cast<int>((1.0f - worstHeadroom) * 100.0f + 0.5f));
+            performanceLabel.setText("CPU " + juce::String(cpuPercent) + "%  V" + juce::String(activeVoices)
+                                     + "  P" + juce::String(activePartials),
+                                     juce::dontSendNotification);
+        }
+
+        // No unconditional repaint: the label repaints itself on change and the
+        // child components manage their own invalidation, so an idle editor
+        // costs nothing.
     }
-    
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AdditiveSynthAudioProcessorEditor)
 };
 